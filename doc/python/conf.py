@@ -75,13 +75,25 @@ magnum.shaders.Flat2D.__annotations__ = {
     'POSITION': magnum.gl.Attribute,
     'TEXTURE_COORDINATES': magnum.gl.Attribute,
     'COLOR3': magnum.gl.Attribute,
-    'COLOR4': magnum.gl.Attribute
+    'COLOR4': magnum.gl.Attribute,
+    'TRANSFORMATION_MATRIX': magnum.gl.Attribute,
+    'TEXTURE_OFFSET': magnum.gl.Attribute,
+    'TRANSFORMATION_PROJECTION_UNIFORM': dict,
+    'DRAW_UNIFORM': dict,
+    'MATERIAL_UNIFORM': dict,
+    'TEXTURE_TRANSFORMATION_UNIFORM': dict
 }
 magnum.shaders.Flat3D.__annotations__ = {
     'POSITION': magnum.gl.Attribute,
     'TEXTURE_COORDINATES': magnum.gl.Attribute,
     'COLOR3': magnum.gl.Attribute,
-    'COLOR4': magnum.gl.Attribute
+    'COLOR4': magnum.gl.Attribute,
+    'TRANSFORMATION_MATRIX': magnum.gl.Attribute,
+    'TEXTURE_OFFSET': magnum.gl.Attribute,
+    'TRANSFORMATION_PROJECTION_UNIFORM': dict,
+    'DRAW_UNIFORM': dict,
+    'MATERIAL_UNIFORM': dict,
+    'TEXTURE_TRANSFORMATION_UNIFORM': dict
 }
 magnum.shaders.VertexColor2D.__annotations__ = {
     'POSITION': magnum.gl.Attribute,
@@ -99,7 +111,16 @@ magnum.shaders.Phong.__annotations__ = {
     'TANGENT': magnum.gl.Attribute,
     'TEXTURE_COORDINATES': magnum.gl.Attribute,
     'COLOR3': magnum.gl.Attribute,
-    'COLOR4': magnum.gl.Attribute
+    'COLOR4': magnum.gl.Attribute,
+    'TRANSFORMATION_MATRIX': magnum.gl.Attribute,
+    'NORMAL_MATRIX': magnum.gl.Attribute,
+    'TEXTURE_OFFSET': magnum.gl.Attribute,
+    'PROJECTION_UNIFORM': dict,
+    'TRANSFORMATION_UNIFORM': dict,
+    'DRAW_UNIFORM': dict,
+    'MATERIAL_UNIFORM': dict,
+    'LIGHT_UNIFORM': dict,
+    'TEXTURE_TRANSFORMATION_UNIFORM': dict
 }
 
 PROJECT_TITLE = 'Magnum'
@@ -25,22 +25,126 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <atomic>
 #include <memory> /* :( */
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <pybind11/pybind11.h>
-#include <Magnum/GL/GL.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/MeshView.h>
+#include <Magnum/GL/OpenGL.h>
 
 #include "Magnum/Python.h"
 
 namespace Magnum { namespace GL {
 
+/* Deferred deletion of GL objects. Destructors of GL objects call into GL,
+   which isn't possible if the last reference is dropped on a thread without
+   a current context. In that case, or if deferral is enabled explicitly
+   (for example to avoid GL calls during garbage collection), the object is
+   pushed to a lock-free list instead and deleted only once the list gets
+   drained on the thread owning the context. The state is global for the
+   whole gl module, as that's where deleters of all GL object holders get
+   instantiated. */
+struct PyDeferredGLObject {
+    void* object;
+    void(*deleter)(void*);
+    PyDeferredGLObject* next;
+};
+
+struct PyDeferredGLObjects {
+    std::atomic<PyDeferredGLObject*> head{};
+    std::atomic<std::size_t> count{};
+    std::atomic<bool> enabled{};
+    /* Thread on which the gl module got imported */
+    std::thread::id thread = std::this_thread::get_id();
+};
+
+/* Estimated memory use of GL objects created through the bindings. Objects
+   are registered on construction and their sizes updated on every data or
+   storage upload, textures track sizes of each level separately. Entries
+   are removed only once the object is actually deleted, so objects waiting
+   for deferred deletion are still counted. Accessed only with the GIL
+   held. */
+enum class PyGLObjectType: UnsignedByte {
+    Buffer, Mesh, Renderbuffer, Texture
+};
+
+struct PyGLObjectMemory {
+    PyGLObjectType type;
+    GLuint id;
+    std::vector<std::size_t> levels;
+};
+
+inline std::unordered_map<const void*, PyGLObjectMemory>& pyGLObjectMemory() {
+    static std::unordered_map<const void*, PyGLObjectMemory> objects;
+    return objects;
+}
+
+inline void pyTrackGLObject(const void* object, PyGLObjectType type, GLuint id) {
+    pyGLObjectMemory().emplace(object, PyGLObjectMemory{type, id, {}});
+}
+
+inline void pyTrackGLObjectSize(const void* object, PyGLObjectType type, GLuint id, std::size_t level, std::size_t size) {
+    /* Objects not created through the bindings get registered on first
+       upload */
+    PyGLObjectMemory& memory = pyGLObjectMemory().emplace(object, PyGLObjectMemory{type, id, {}}).first->second;
+    if(memory.levels.size() <= level) memory.levels.resize(level + 1);
+    memory.levels[level] = size;
+}
+
+inline PyDeferredGLObjects& pyDeferredGLObjects() {
+    static PyDeferredGLObjects objects;
+    return objects;
+}
+
+/* Returns count of deleted objects. Expects that a context is current. */
+inline std::size_t pyDeleteDeferredGLObjects() {
+    PyDeferredGLObjects& objects = pyDeferredGLObjects();
+    std::size_t count = 0;
+    for(PyDeferredGLObject* object = objects.head.exchange(nullptr); object; ++count) {
+        PyDeferredGLObject* next = object->next;
+        object->deleter(object->object);
+        delete object;
+        object = next;
+    }
+    objects.count -= count;
+    return count;
+}
+
+template<class T> struct PyGLObjectDeleter {
+    void operator()(T* object) {
+        PyDeferredGLObjects& objects = pyDeferredGLObjects();
+        /* Objects without an underlying GL object (such as NoCreate'd
+           instances) can be deleted right away */
+        if(!object->id() || (!objects.enabled && GL::Context::hasCurrent() && std::this_thread::get_id() == objects.thread)) {
+            pyGLObjectMemory().erase(object);
+            delete object;
+            return;
+        }
+
+        PyDeferredGLObject* deferred = new PyDeferredGLObject{object, [](void* object) {
+            pyGLObjectMemory().erase(object);
+            delete static_cast<T*>(object);
+        }, objects.head.load()};
+        while(!objects.head.compare_exchange_weak(deferred->next, deferred));
+        ++objects.count;
+    }
+};
+
+template<class T> using PyGLObjectHolder = std::unique_ptr<T, PyGLObjectDeleter<T>>;
+
 /* Stores additional stuff needed for proper refcounting of buffers owned by
    a mesh. For some reason it *has to be* templated, otherwise
    PYBIND11_DECLARE_HOLDER_TYPE doesn't work. Ugh. */
-template<class T> struct PyMeshHolder: std::unique_ptr<T> {
+template<class T> struct PyMeshHolder: PyGLObjectHolder<T> {
     static_assert(std::is_same<T, GL::Mesh>::value, "mesh holder has to hold a mesh");
 
-    explicit PyMeshHolder(T* object): std::unique_ptr<T>{object} {}
+    explicit PyMeshHolder(T* object): PyGLObjectHolder<T>{object} {}
 
     std::vector<pybind11::object> buffers;
 };
@@ -53,9 +157,41 @@ template<class T> struct PyFramebufferHolder: std::unique_ptr<T, PyNonDestructib
     std::vector<pybind11::object> attachments;
 };
 
+/* Keeps the original mesh alive for as long as the view exists */
+template<class T> struct PyMeshViewHolder: std::unique_ptr<T> {
+    static_assert(std::is_same<T, GL::MeshView>::value, "mesh view holder has to hold a mesh view");
+
+    explicit PyMeshViewHolder(T* object): PyMeshViewHolder{object, pybind11::none{}} {}
+
+    explicit PyMeshViewHolder(T* object, pybind11::object mesh): std::unique_ptr<T>{object}, mesh{std::move(mesh)} {}
+
+    pybind11::object mesh;
+};
+
+/* Shared between the gl and shaders modules as every shader subclass needs
+   to expose the draw() overloads again, otherwise the base ones get
+   shadowed. All views have to be from the same mesh, checking that here
+   instead of letting Magnum assert. */
+inline void pyMultiDraw(GL::AbstractShaderProgram& shader, const std::vector<GL::MeshView*>& meshes) {
+    if(meshes.empty()) return;
+
+    std::vector<Containers::Reference<GL::MeshView>> references;
+    references.reserve(meshes.size());
+    for(GL::MeshView* mesh: meshes) {
+        if(&mesh->mesh() != &meshes.front()->mesh()) {
+            PyErr_SetString(PyExc_ValueError, "all mesh views have to be from the same mesh");
+            throw pybind11::error_already_set{};
+        }
+        references.emplace_back(*mesh);
+    }
+
+    shader.draw(Containers::ArrayView<const Containers::Reference<GL::MeshView>>{references});
+}
+
 }}
 
 PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyMeshHolder<T>)
 PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyFramebufferHolder<T>)
+PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyMeshViewHolder<T>)
 
 #endif
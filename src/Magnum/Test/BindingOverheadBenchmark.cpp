@@ -0,0 +1,171 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "Magnum/Magnum.h"
+#include "Magnum/Math/Matrix4.h"
+#include "Magnum/Trade/AbstractImporter.h"
+#include "Magnum/Trade/ImageData.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Test { namespace {
+
+/* Native counterparts of operations exposed through the bindings. The names
+   match the ones in src/python/magnum/test/benchmark_overhead.py, which runs
+   the same operations from Python and reports the overhead ratio. Every
+   benchmark does a single operation per iteration so the times are
+   comparable to a single Python call. */
+struct BindingOverheadBenchmark: TestSuite::Tester {
+    explicit BindingOverheadBenchmark();
+
+    void vectorAdd();
+    void vectorDot();
+    void matrixMultiply();
+    void matrixInverted();
+    void arrayViewSlice();
+    void stridedArrayViewSlice();
+    void importerOpenFile();
+    void importerImage2D();
+
+    PluginManager::Manager<Trade::AbstractImporter> _manager;
+};
+
+enum: std::size_t { Repeats = 10000 };
+
+BindingOverheadBenchmark::BindingOverheadBenchmark() {
+    addBenchmarks({&BindingOverheadBenchmark::vectorAdd,
+                   &BindingOverheadBenchmark::vectorDot,
+                   &BindingOverheadBenchmark::matrixMultiply,
+                   &BindingOverheadBenchmark::matrixInverted,
+                   &BindingOverheadBenchmark::arrayViewSlice,
+                   &BindingOverheadBenchmark::stridedArrayViewSlice,
+                   &BindingOverheadBenchmark::importerOpenFile,
+                   &BindingOverheadBenchmark::importerImage2D}, 10);
+}
+
+/* The compiler is free to optimize the operations away if the result isn't
+   used in any way, so each benchmark feeds the result back or accumulates it
+   and checks it at the end. The values are picked so the results are exact
+   even after many iterations. */
+
+void BindingOverheadBenchmark::vectorAdd() {
+    Vector3 a{1.0f, 2.0f, 3.0f};
+    const Vector3 b{1.0f, 0.0f, 0.0f};
+    CORRADE_BENCHMARK(Repeats) {
+        a = a + b;
+    }
+
+    CORRADE_COMPARE(a, (Vector3{1.0f + Repeats, 2.0f, 3.0f}));
+}
+
+void BindingOverheadBenchmark::vectorDot() {
+    const Vector3 a{1.0f, 2.0f, 3.0f};
+    Float sum = 0.0f;
+    CORRADE_BENCHMARK(Repeats) {
+        sum += Math::dot(a, a);
+    }
+
+    CORRADE_COMPARE(sum, 14.0f*Repeats);
+}
+
+void BindingOverheadBenchmark::matrixMultiply() {
+    Matrix4 a = Matrix4::translation({1.0f, 2.0f, 3.0f});
+    const Matrix4 b = Matrix4::translation(Vector3::xAxis());
+    CORRADE_BENCHMARK(Repeats) {
+        a = a*b;
+    }
+
+    CORRADE_COMPARE(a.translation(), (Vector3{1.0f + Repeats, 2.0f, 3.0f}));
+}
+
+void BindingOverheadBenchmark::matrixInverted() {
+    /* Inverting an even number of times gives back the original */
+    const Matrix4 original = Matrix4::translation({1.0f, 2.0f, 3.0f})*Matrix4::scaling({2.0f, 4.0f, 0.5f});
+    Matrix4 a = original;
+    CORRADE_BENCHMARK(Repeats) {
+        a = a.inverted();
+    }
+
+    CORRADE_COMPARE(a, original);
+}
+
+void BindingOverheadBenchmark::arrayViewSlice() {
+    const char data[]{"hello world"};
+    const Containers::ArrayView<const char> view = data;
+    std::size_t sum = 0;
+    CORRADE_BENCHMARK(Repeats) {
+        sum += view.slice(1, 5).size();
+    }
+
+    CORRADE_COMPARE(sum, 4*Repeats);
+}
+
+void BindingOverheadBenchmark::stridedArrayViewSlice() {
+    const char data[]{"hello world"};
+    const Containers::StridedArrayView1D<const char> view = Containers::arrayView(data);
+    std::size_t sum = 0;
+    CORRADE_BENCHMARK(Repeats) {
+        sum += view.slice(1, 5).size();
+    }
+
+    CORRADE_COMPARE(sum, 4*Repeats);
+}
+
+void BindingOverheadBenchmark::importerOpenFile() {
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.loadAndInstantiate("StbImageImporter");
+    if(!importer) CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    const std::string filename = Utility::Directory::join(PYTHON_TEST_DIR, "rgb.png");
+    std::size_t opened = 0;
+    CORRADE_BENCHMARK(10) {
+        opened += importer->openFile(filename);
+    }
+
+    CORRADE_COMPARE(opened, 10);
+}
+
+void BindingOverheadBenchmark::importerImage2D() {
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.loadAndInstantiate("StbImageImporter");
+    if(!importer) CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PYTHON_TEST_DIR, "rgb.png")));
+    std::size_t loaded = 0;
+    CORRADE_BENCHMARK(10) {
+        loaded += !!importer->image2D(0);
+    }
+
+    CORRADE_COMPARE(loaded, 10);
+}
+
+}}}
+
+CORRADE_TEST_MAIN(Magnum::Test::BindingOverheadBenchmark)
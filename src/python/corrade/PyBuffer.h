@@ -39,8 +39,15 @@ namespace corrade {
    like hell), doing my own thing here instead. IMAGINE, I can pass flags to
    say what features I'm able to USE! WOW! */
 
+/* Type the protocol was enabled on, for the fast path below */
+template<class Class, bool(*getter)(Class&, Py_buffer&, int)> PyTypeObject*& betterBufferProtocolType() {
+    static PyTypeObject* type{};
+    return type;
+}
+
 template<class Class, bool(*getter)(Class&, Py_buffer&, int)> void enableBetterBufferProtocol(py::object& object) {
     auto& typeObject = reinterpret_cast<PyHeapTypeObject&>(*object.ptr());
+    betterBufferProtocolType<Class, getter>() = &typeObject.ht_type;
     /* Sanity check -- we expect pybind set up its own buffer functions before
        us */
     CORRADE_INTERNAL_ASSERT(typeObject.as_buffer.bf_getbuffer == pybind11::detail::pybind11_getbuffer);
@@ -53,7 +60,16 @@ template<class Class, bool(*getter)(Class&, Py_buffer&, int)> void enableBetterB
            fails for some reason, give up. Need to list all members otherwise
            GCC 4.8 loudly complains about missing initializers. */
         *buffer = Py_buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
-        if(!getter(pyInstanceFromHandle<Class>(obj), *buffer, flags)) {
+
+        /* If the object is exactly of the type the protocol was enabled on,
+           the instance pointer is fetched directly, skipping the type lookup
+           done by pyInstanceFromHandle(). For small math types that lookup
+           is most of the time spent in np.array(Vector3) or memoryview().
+           Subclasses go the slow way. */
+        Class& instance = Py_TYPE(obj) == betterBufferProtocolType<Class, getter>() ?
+            *static_cast<Class*>(reinterpret_cast<pybind11::detail::instance*>(obj)->get_value_and_holder().value_ptr()) :
+            pyInstanceFromHandle<Class>(obj);
+        if(!getter(instance, *buffer, flags)) {
             CORRADE_INTERNAL_ASSERT(!buffer->obj);
             CORRADE_INTERNAL_ASSERT(PyErr_Occurred());
             return -1;
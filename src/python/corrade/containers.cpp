@@ -23,10 +23,16 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h> /* so ArrayView is convertible from python array */
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Directory.h>
+
+#ifdef CORRADE_TARGET_UNIX
+#include <sys/mman.h>
+#endif
 
 #include "Corrade/Containers/Python.h"
 
@@ -310,6 +316,99 @@ inline std::size_t largerStride(std::size_t a, std::size_t b) {
     return a < b ? b : a; /* max(), but named like this to avoid clashes */
 }
 
+/* Indices for take() / put(), from a one-dimensional buffer of any integer
+   type. All indices are checked upfront so nothing gets copied if any of
+   them is out of range. */
+template<class T> void readIndices(const Py_buffer& buffer, const std::size_t bound, Containers::ArrayView<std::size_t> out) {
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        const T index = *reinterpret_cast<const T*>(static_cast<const char*>(buffer.buf) + i*buffer.strides[0]);
+        /* Negative values wrap around to huge values and fail the check */
+        if(std::size_t(index) >= bound) {
+            PyErr_Format(PyExc_IndexError, "index %lld out of range for %zu items", static_cast<long long>(index), bound);
+            throw py::error_already_set{};
+        }
+        out[i] = std::size_t(index);
+    }
+}
+
+Containers::Array<std::size_t> indices(py::buffer indices, const std::size_t bound) {
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    if(PyObject_GetBuffer(indices.ptr(), &buffer, PyBUF_STRIDES|PyBUF_FORMAT) != 0)
+        throw py::error_already_set{};
+
+    Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+
+    if(buffer.ndim != 1) {
+        PyErr_Format(PyExc_BufferError, "expected 1 dimension but got %i", buffer.ndim);
+        throw py::error_already_set{};
+    }
+
+    /* Native byte order only */
+    const char* format = buffer.format ? buffer.format : "B";
+    if(*format == '@' || *format == '=') ++format;
+
+    Containers::Array<std::size_t> out{Containers::NoInit, std::size_t(buffer.shape[0])};
+    if(std::strlen(format) != 1) format = "";
+    switch(*format) {
+        case 'b': readIndices<signed char>(buffer, bound, out); break;
+        case 'B': readIndices<unsigned char>(buffer, bound, out); break;
+        case 'h': readIndices<short>(buffer, bound, out); break;
+        case 'H': readIndices<unsigned short>(buffer, bound, out); break;
+        case 'i': readIndices<int>(buffer, bound, out); break;
+        case 'I': readIndices<unsigned int>(buffer, bound, out); break;
+        case 'l': readIndices<long>(buffer, bound, out); break;
+        case 'L': readIndices<unsigned long>(buffer, bound, out); break;
+        case 'q': readIndices<long long>(buffer, bound, out); break;
+        case 'Q': readIndices<unsigned long long>(buffer, bound, out); break;
+        case 'n': readIndices<Py_ssize_t>(buffer, bound, out); break;
+        case 'N': readIndices<std::size_t>(buffer, bound, out); break;
+        default:
+            PyErr_Format(PyExc_BufferError, "expected an integer index type but got %s", buffer.format);
+            throw py::error_already_set{};
+    }
+
+    return out;
+}
+
+/* Copies a single item of a view, which is either a byte or a sub-view.
+   Contiguous rows, such as vertices in an interleaved vertex buffer, are
+   copied in one go. */
+inline void copyItem(const char& src, char& dst) { dst = src; }
+inline void copyItem(const Containers::StridedArrayView1D<const char>& src, const Containers::StridedArrayView1D<char>& dst) {
+    if(src.stride() == 1 && dst.stride() == 1) {
+        std::memcpy(dst.data(), src.data(), src.size());
+        return;
+    }
+    for(std::size_t i = 0; i != src.size(); ++i) dst[i] = src[i];
+}
+template<unsigned dimensions> void copyItem(const Containers::StridedArrayView<dimensions, const char>& src, const Containers::StridedArrayView<dimensions, char>& dst) {
+    for(std::size_t i = 0, size = Containers::StridedDimensions<dimensions, const std::size_t>{src.size()}[0]; i != size; ++i)
+        copyItem(src[i], dst[i]);
+}
+
+/* Whether two views have the same size in all but the top-level dimension */
+template<unsigned dimensions> bool sameItemSize(const Containers::StridedDimensions<dimensions, std::size_t>& a, const Containers::StridedDimensions<dimensions, std::size_t>& b) {
+    for(std::size_t i = 1; i != dimensions; ++i)
+        if(a[i] != b[i]) return false;
+    return true;
+}
+
+template<unsigned dimensions> void take(const Containers::StridedArrayView<dimensions, const char>& src, Containers::ArrayView<const std::size_t> indices, const Containers::StridedArrayView<dimensions, char>& dst) {
+    if(Containers::StridedDimensions<dimensions, const std::size_t>{dst.size()}[0] != indices.size()) {
+        PyErr_Format(PyExc_ValueError, "expected %zu items in the output view but got %zu", indices.size(), Containers::StridedDimensions<dimensions, const std::size_t>{dst.size()}[0]);
+        throw py::error_already_set{};
+    }
+    if(!sameItemSize<dimensions>(src.size(), dst.size())) {
+        PyErr_SetString(PyExc_ValueError, "output view items have a different size than source items");
+        throw py::error_already_set{};
+    }
+
+    py::gil_scoped_release release;
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        copyItem(src[indices[i]], dst[i]);
+}
+
 template<unsigned dimensions, class T> void stridedArrayView(py::class_<Containers::StridedArrayView<dimensions, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<dimensions, T>>>& c) {
     /* Implicitly convertible from a buffer */
     py::implicitly_convertible<py::buffer, Containers::StridedArrayView<dimensions, T>>();
@@ -381,7 +480,32 @@ template<unsigned dimensions, class T> void stridedArrayView(py::class_<Containe
             const Slice calculated = calculateSlice(slice, Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]);
             const auto sliced = self.slice(calculated.start, calculated.stop).every(calculated.step);
             return Containers::pyArrayViewHolder(sliced, calculated.start == calculated.stop ? py::none{} : pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
-        }, "Slice the view");
+        }, "Slice the view")
+
+        /* Gather in the top dimension */
+        .def("take", [](const Containers::StridedArrayView<dimensions, T>& self, py::buffer indices) {
+            const Containers::Array<std::size_t> i = corrade::indices(indices, Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]);
+
+            /* The output is a tightly packed bytearray of the same shape
+               except for the top-level dimension */
+            Containers::StridedDimensions<dimensions, std::size_t> size{self.size()};
+            size[0] = i.size();
+            Containers::StridedDimensions<dimensions, std::ptrdiff_t> stride;
+            std::size_t total = 1;
+            for(std::size_t d = dimensions; d != 0; --d) {
+                stride[d - 1] = std::ptrdiff_t(total);
+                total *= size[d - 1];
+            }
+
+            py::object owner = py::reinterpret_steal<py::object>(PyByteArray_FromStringAndSize(nullptr, Py_ssize_t(total)));
+            if(!owner) throw py::error_already_set{};
+            const Containers::StridedArrayView<dimensions, char> out{{PyByteArray_AS_STRING(owner.ptr()), total}, size, stride};
+            take<dimensions>(self, i, out);
+            return Containers::pyArrayViewHolder(out, total ? owner : py::none{});
+        }, "Gather items at given indices into a new view", py::arg("indices"))
+        .def("take", [](const Containers::StridedArrayView<dimensions, T>& self, py::buffer indices, const Containers::StridedArrayView<dimensions, char>& out) {
+            take<dimensions>(self, corrade::indices(indices, Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]), out);
+        }, "Gather items at given indices into an existing view", py::arg("indices"), py::arg("out"));
 
     enableBetterBufferProtocol<Containers::StridedArrayView<dimensions, T>, stridedArrayViewBufferProtocol>(c);
 }
@@ -629,6 +753,51 @@ template<class T> void mutableStridedArrayView4D(py::class_<Containers::StridedA
         }, "Set a value at given position");
 }
 
+template<unsigned dimensions, class T> void mutableStridedArrayView(py::class_<Containers::StridedArrayView<dimensions, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<dimensions, T>>>& c) {
+    c
+        /* Scatter in the top dimension. Duplicate indices are allowed, the
+           last value wins. */
+        .def("put", [](const Containers::StridedArrayView<dimensions, T>& self, py::buffer indices, const Containers::StridedArrayView<dimensions, const char>& values) {
+            const Containers::Array<std::size_t> i = corrade::indices(indices, Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]);
+            if(Containers::StridedDimensions<dimensions, const std::size_t>{values.size()}[0] != i.size()) {
+                PyErr_Format(PyExc_ValueError, "expected %zu values but got %zu", i.size(), Containers::StridedDimensions<dimensions, const std::size_t>{values.size()}[0]);
+                throw py::error_already_set{};
+            }
+            if(!sameItemSize<dimensions>(self.size(), values.size())) {
+                PyErr_SetString(PyExc_ValueError, "values have a different item size than the view");
+                throw py::error_already_set{};
+            }
+
+            py::gil_scoped_release release;
+            for(std::size_t j = 0; j != i.size(); ++j)
+                copyItem(values[j], self[i[j]]);
+        }, "Scatter values to given indices", py::arg("indices"), py::arg("values"));
+}
+
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define CORRADE_PY_MAP_FILE
+/* Owner of views returned from map_file(). The mapping is released once
+   this object and all views referencing it are gone. */
+struct PyMappedFile {
+    Containers::Array<const char, Utility::Directory::MapDeleter> read;
+    Containers::Array<char, Utility::Directory::MapDeleter> write;
+};
+
+void adviseMappedFile(const char* data, std::size_t size, bool sequential, bool willNeed) {
+    #ifdef CORRADE_TARGET_UNIX
+    /* Only hints, failures are not an error */
+    void* const pointer = const_cast<char*>(data);
+    if(sequential) madvise(pointer, size, MADV_SEQUENTIAL);
+    if(willNeed) madvise(pointer, size, MADV_WILLNEED);
+    #else
+    static_cast<void>(data);
+    static_cast<void>(size);
+    static_cast<void>(sequential);
+    static_cast<void>(willNeed);
+    #endif
+}
+#endif
+
 }
 
 void containers(py::module& m) {
@@ -682,10 +851,45 @@ void containers(py::module& m) {
     stridedArrayView(mutableStridedArrayView4D_);
     stridedArrayViewND(mutableStridedArrayView4D_);
     stridedArrayView4D(mutableStridedArrayView4D_);
+    mutableStridedArrayView(mutableStridedArrayView1D_);
+    mutableStridedArrayView(mutableStridedArrayView2D_);
+    mutableStridedArrayView(mutableStridedArrayView3D_);
+    mutableStridedArrayView(mutableStridedArrayView4D_);
     mutableStridedArrayView1D(mutableStridedArrayView1D_);
     mutableStridedArrayView2D(mutableStridedArrayView2D_);
     mutableStridedArrayView3D(mutableStridedArrayView3D_);
     mutableStridedArrayView4D(mutableStridedArrayView4D_);
+
+    #ifdef CORRADE_PY_MAP_FILE
+    py::class_<PyMappedFile>{m, "MappedFile", "Memory-mapped file"};
+
+    m.def("map_file", [](const std::string& filename, const std::string& mode, std::size_t size, bool sequential, bool willNeed) -> py::object {
+        PyMappedFile file;
+        if(mode == "r") file.read = Utility::Directory::mapRead(filename);
+        else if(mode == "r+") file.write = Utility::Directory::map(filename);
+        else if(mode == "w") file.write = Utility::Directory::mapWrite(filename, size);
+        else {
+            PyErr_Format(PyExc_ValueError, "unknown mode %s, expected r, r+ or w", mode.data());
+            throw py::error_already_set{};
+        }
+
+        if(!file.read && !file.write) {
+            PyErr_Format(PyExc_RuntimeError, "cannot map %s", filename.data());
+            throw py::error_already_set{};
+        }
+
+        /* Copy the view out before the arrays get moved into the owner */
+        if(file.read) {
+            const Containers::ArrayView<const char> view = file.read;
+            adviseMappedFile(view.data(), view.size(), sequential, willNeed);
+            return pyCastButNotShitty(Containers::pyArrayViewHolder(view, py::cast(std::move(file))));
+        }
+
+        const Containers::ArrayView<char> view = file.write;
+        adviseMappedFile(view.data(), view.size(), sequential, willNeed);
+        return pyCastButNotShitty(Containers::pyArrayViewHolder(view, py::cast(std::move(file))));
+    }, "Map a file into memory", py::arg("filename"), py::arg("mode") = "r", py::arg("size") = 0, py::arg("sequential") = false, py::arg("will_need") = false);
+    #endif
 }
 
 }
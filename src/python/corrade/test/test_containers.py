@@ -24,7 +24,9 @@
 #
 
 import array
+import os
 import sys
+import tempfile
 import unittest
 
 from corrade import containers
@@ -233,6 +235,61 @@ class ArrayView(unittest.TestCase):
         b[-1] = ord('?')
         self.assertEqual(a, b'World is hell?')
 
+@unittest.skipUnless(hasattr(containers, 'map_file'), "file mapping not available on this platform")
+class MapFile(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.filename = os.path.join(self.tmp.name, 'file.bin')
+        with open(self.filename, 'wb') as f:
+            f.write(b'hello world')
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def test_read(self):
+        a = containers.map_file(self.filename, sequential=True, will_need=True)
+        self.assertIsInstance(a, containers.ArrayView)
+        self.assertIsInstance(a.owner, containers.MappedFile)
+        self.assertEqual(bytes(a), b'hello world')
+        self.assertEqual(bytes(memoryview(a)[6:]), b'world')
+
+        # Slices keep the mapping alive
+        owner_refcount = sys.getrefcount(a.owner)
+        b = a[6:]
+        self.assertIs(b.owner, a.owner)
+        self.assertEqual(sys.getrefcount(a.owner), owner_refcount + 1)
+        del a
+        self.assertEqual(bytes(b), b'world')
+
+    def test_read_write(self):
+        a = containers.map_file(self.filename, 'r+')
+        self.assertIsInstance(a, containers.MutableArrayView)
+        a[0] = ord('j')
+        del a
+
+        with open(self.filename, 'rb') as f:
+            self.assertEqual(f.read(), b'jello world')
+
+    def test_write(self):
+        filename = os.path.join(self.tmp.name, 'new.bin')
+        a = containers.map_file(filename, 'w', size=3)
+        self.assertEqual(len(a), 3)
+        a[0] = ord('a')
+        a[1] = ord('b')
+        a[2] = ord('c')
+        del a
+
+        with open(filename, 'rb') as f:
+            self.assertEqual(f.read(), b'abc')
+
+    def test_invalid_mode(self):
+        with self.assertRaisesRegex(ValueError, "unknown mode a, expected r, r\\+ or w"):
+            containers.map_file(self.filename, 'a')
+
+    def test_nonexistent(self):
+        with self.assertRaisesRegex(RuntimeError, "cannot map /nonexistent.bin"):
+            containers.map_file('/nonexistent.bin')
+
 class StridedArrayView1D(unittest.TestCase):
     def test_init(self):
         a = containers.StridedArrayView1D()
@@ -424,6 +481,46 @@ class StridedArrayView1D(unittest.TestCase):
         b[-1] = ord('?')
         self.assertEqual(a, b'World is hell?')
 
+    def test_take(self):
+        a = containers.StridedArrayView1D(b'hello')[::-1]
+        b = a.take(array.array('H', [0, 0, 4, 2]))
+        self.assertIsInstance(b, containers.MutableStridedArrayView1D)
+        self.assertIsInstance(b.owner, bytearray)
+        self.assertEqual(bytes(b), b'oohl')
+
+        c = bytearray(2)
+        a.take(array.array('q', [1, 3]), out=c)
+        self.assertEqual(c, b'le')
+
+    def test_take_empty(self):
+        b = containers.StridedArrayView1D(b'hello').take(array.array('i'))
+        self.assertEqual(len(b), 0)
+        self.assertIs(b.owner, None)
+
+    def test_take_invalid(self):
+        a = containers.StridedArrayView1D(b'hello')
+        with self.assertRaisesRegex(IndexError, "index 5 out of range for 5 items"):
+            a.take(array.array('I', [0, 5]))
+        with self.assertRaisesRegex(IndexError, "index -1 out of range for 5 items"):
+            a.take(array.array('b', [-1]))
+        with self.assertRaisesRegex(BufferError, "expected an integer index type but got f"):
+            a.take(array.array('f', [0.0]))
+        with self.assertRaisesRegex(ValueError, "expected 2 items in the output view but got 3"):
+            a.take(array.array('B', [0, 1]), out=bytearray(3))
+
+    def test_put(self):
+        a = bytearray(b'hello')
+        containers.MutableStridedArrayView1D(a).put(array.array('l', [0, 4, 0]), b'yjp')
+        self.assertEqual(a, b'pellj')
+
+        # Nothing is written if any index is out of range
+        with self.assertRaisesRegex(IndexError, "index 7 out of range for 5 items"):
+            containers.MutableStridedArrayView1D(a).put(array.array('l', [1, 7]), b'xx')
+        self.assertEqual(a, b'pellj')
+
+        with self.assertRaisesRegex(ValueError, "expected 2 values but got 3"):
+            containers.MutableStridedArrayView1D(a).put(array.array('B', [0, 1]), b'xyz')
+
 class StridedArrayView2D(unittest.TestCase):
     def test_init(self):
         a = containers.StridedArrayView2D()
@@ -699,6 +796,33 @@ class StridedArrayView2D(unittest.TestCase):
         self.assertEqual(sys.getrefcount(a), a_refcount + 1)
         self.assertEqual(sys.getrefcount(b), b_refcount + 1)
 
+    def test_take(self):
+        # Reshuffling three-byte vertices using an index buffer
+        a = containers.StridedArrayView2D(memoryview(b'abcdefghijkl').cast('b', (4, 3)))
+        b = a.take(array.array('I', [3, 0, 3]))
+        self.assertIsInstance(b, containers.MutableStridedArrayView2D)
+        self.assertEqual(b.size, (3, 3))
+        self.assertEqual(b.stride, (3, 1))
+        self.assertEqual(bytes(b), b'jklabcjkl')
+
+        # Non-contiguous items
+        c = a[:, ::2].take(array.array('I', [1, 2]))
+        self.assertEqual(bytes(c), b'dfgi')
+
+    def test_take_invalid(self):
+        a = containers.StridedArrayView2D(memoryview(b'abcdefghijkl').cast('b', (4, 3)))
+        with self.assertRaisesRegex(ValueError, "output view items have a different size than source items"):
+            a.take(array.array('I', [0]), out=containers.MutableStridedArrayView2D(memoryview(bytearray(2)).cast('b', (1, 2))))
+
+    def test_put(self):
+        a = bytearray(b'abcdefghijkl')
+        b = containers.MutableStridedArrayView2D(memoryview(a).cast('b', (4, 3)))
+        b.put(array.array('H', [2, 0]), memoryview(b'XYZxyz').cast('b', (2, 3)))
+        self.assertEqual(a, b'xyzdefXYZjkl')
+
+        with self.assertRaisesRegex(ValueError, "values have a different item size than the view"):
+            b.put(array.array('H', [2]), memoryview(b'XY').cast('b', (1, 2)))
+
 class StridedArrayView3D(unittest.TestCase):
     def test_init_buffer(self):
         a = (b'01234567'
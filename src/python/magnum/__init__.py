@@ -49,7 +49,7 @@ if 'scenegraph' in globals():
         sys.modules['magnum.scenegraph.' + i] = getattr(scenegraph, i)
 
 __all__ = [
-    'Deg', 'Rad',
+    'Deg', 'Rad', 'DegArray', 'RadArray',
 
     'BoolVector2', 'BoolVector3', 'BoolVector4',
     'Vector2', 'Vector3', 'Vector4',
@@ -78,7 +78,12 @@ __all__ = [
     'ImageView1D', 'ImageView2D', 'ImageView3D',
     'MutableImageView1D', 'MutableImageView2D', 'MutableImageView3D',
 
-    'SamplerFilter', 'SamplerMipmap', 'SamplerWrapping'
+    'SamplerFilter', 'SamplerMipmap', 'SamplerWrapping',
+
+    'ResourceState', 'ResourceDataState', 'ResourcePolicy',
+    'Resource', 'ResourceManager', 'AbstractResourceLoader',
+
+    'TraceZone'
 
     # TARGET_*, BUILD_* are omitted as `from magnum import *` would pull them
     # to globals and this would likely cause conflicts (corrade also defines
@@ -51,13 +51,23 @@ template<class T> struct PyDimensionTraits<3, T> {
 };
 
 void math(py::module& root, py::module& m);
+void mathFunctions(py::module& root, py::module& m);
 void mathVectorFloat(py::module& root, py::module& m);
 void mathVectorIntegral(py::module& root, py::module& m);
 void mathMatrixFloat(py::module& root, PyTypeObject* metaclass);
 void mathMatrixDouble(py::module& root, PyTypeObject* metaclass);
 void mathRange(py::module& root, py::module& m);
+void mathAlgorithms(py::module& m);
+void mathSpatialHash(py::module& m);
+
+void resourceManager(py::module& m);
+void threadPool(py::module& m);
+void tracing(py::module& m);
+void cpu(py::module& m);
+void allocations(py::module& m);
 
 void gl(py::module& m);
+void glTextureStreamer(py::module& m);
 void meshtools(py::module& m);
 void primitives(py::module& m);
 void scenegraph(py::module& m);
@@ -0,0 +1,93 @@
+#ifndef magnum_cpu_h
+#define magnum_cpu_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <pybind11/pybind11.h>
+
+#include "magnum/bootstrap.h"
+
+/* Instruction sets that kernels can be compiled for in addition to the
+   baseline. With GCC and Clang the target attribute allows using intrinsics
+   of a given set in a single function without enabling it for the whole
+   file, MSVC allows that always. */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MAGNUM_PY_CPU_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define MAGNUM_PY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MAGNUM_PY_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq")))
+#else
+#define MAGNUM_PY_TARGET_AVX2
+#define MAGNUM_PY_TARGET_AVX512
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define MAGNUM_PY_CPU_NEON
+#endif
+
+/* Kernels written with GCC / Clang vector extensions, which map to SSE2 and
+   AVX2 on x86 and to NEON on ARM. Elsewhere only scalar variants are
+   available. Helpers operating on the vectors are forced inline so they get
+   compiled for the instruction set of the kernel calling them. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(MAGNUM_PY_CPU_X86) || defined(MAGNUM_PY_CPU_NEON))
+#define MAGNUM_PY_VECTOR_KERNELS
+#define MAGNUM_PY_ALWAYS_INLINE __attribute__((always_inline)) inline
+#endif
+
+namespace magnum {
+
+/* Ordered, so a level implies all lower ones on the same architecture */
+enum class PyCpuLevel: UnsignedInt {
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512,
+    Neon
+};
+
+/* The level is chosen once when the root module is imported, see
+   magnum.cpu.cpp */
+inline PyCpuLevel pyCpuLevel() {
+    static PyCpuLevel level = PyCpuLevel(py::module::import("_magnum").attr("_cpu_level").cast<UnsignedInt>());
+    return level;
+}
+
+/* Picks the best kernel variant for the selected level. Variants not
+   implemented for a particular kernel can be null, in which case the next
+   lower one is used. On x86 the SSE2 variant is expected to be always
+   present, as SSE2 is the baseline of 64-bit x86. */
+template<class T> T pyCpuDispatch(T scalar, T sse2, T avx2, T avx512, T neon) {
+    switch(pyCpuLevel()) {
+        case PyCpuLevel::Avx512: if(avx512) return avx512; /* fallthrough */
+        case PyCpuLevel::Avx2: if(avx2) return avx2; /* fallthrough */
+        case PyCpuLevel::Sse2: if(sse2) return sse2; break;
+        case PyCpuLevel::Neon: if(neon) return neon; break;
+        case PyCpuLevel::Scalar: break;
+    }
+    return scalar;
+}
+
+}
+
+#endif
@@ -23,17 +23,24 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <memory>
+#include <unordered_map>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> /* for Mesh.buffers */
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/Attribute.h>
 #include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
@@ -42,6 +49,7 @@
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/Version.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 
 #include "Corrade/Python.h"
 #include "Magnum/Python.h"
@@ -49,6 +57,7 @@
 
 #include "corrade/EnumOperators.h"
 #include "magnum/bootstrap.h"
+#include "magnum/tracing.h"
 
 namespace magnum { namespace {
 
@@ -98,10 +107,91 @@ template<class T> void setUniform(GL::AbstractShaderProgram& self, Int location,
     static_cast<PublicizedAbstractShaderProgram&>(self).setUniform(location, value);
 }
 
-template<UnsignedInt dimensions> void texture(py::class_<GL::Texture<dimensions>, GL::AbstractTexture>& c) {
+#if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+/* Framebuffer read into a pixel pack buffer, fetched once a fence signals
+   that the GPU finished the copy. The fence is polled from the event loop,
+   so neither the loop nor the GPU pipeline gets stalled. */
+struct AsyncFramebufferRead {
+    GL::BufferImage2D image;
+    GLsync fence;
+    PixelFormat format;
+    py::object loop;
+    py::object future;
+};
+
+void pollAsyncFramebufferRead(std::shared_ptr<AsyncFramebufferRead> read) {
+    if(py::cast<bool>(read->future.attr("cancelled")())) {
+        glDeleteSync(read->fence);
+        return;
+    }
+
+    if(!GL::Context::hasCurrent()) {
+        glDeleteSync(read->fence);
+        read->future.attr("set_exception")(py::reinterpret_borrow<py::object>(PyExc_RuntimeError)("no context is current"));
+        return;
+    }
+
+    /* Not done yet, check again in the next loop iteration */
+    if(glClientWaitSync(read->fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        read->loop.attr("call_soon")(py::cpp_function{[read]() {
+            pollAsyncFramebufferRead(read);
+        }});
+        return;
+    }
+
+    glDeleteSync(read->fence);
+    GL::Buffer& buffer = read->image.buffer();
+    const Containers::ArrayView<const char> mapped = buffer.map(0, read->image.dataSize(), GL::Buffer::MapFlag::Read);
+    Containers::Array<char> data{Containers::NoInit, mapped.size()};
+    Utility::copy(mapped, data);
+    buffer.unmap();
+
+    read->future.attr("set_result")(Image2D{read->format, read->image.size(), std::move(data)});
+}
+#endif
+
+/* Indexed with GL::PyGLObjectType */
+const char* const GLObjectTypeNames[]{"buffer", "mesh", "renderbuffer", "texture"};
+
+/* Pixel size of a GL texture or renderbuffer format, used for memory
+   accounting. Compressed and otherwise unknown formats are estimated as four
+   bytes per pixel. */
+std::size_t formatSize(GLenum format) {
+    static const std::unordered_map<GLenum, std::size_t> sizes = []() {
+        std::unordered_map<GLenum, std::size_t> sizes{
+            {GL_DEPTH_COMPONENT16, 2},
+            {GL_STENCIL_INDEX8, 1},
+            #ifndef MAGNUM_TARGET_GLES2
+            {GL_DEPTH_COMPONENT24, 4},
+            {GL_DEPTH_COMPONENT32F, 4},
+            {GL_DEPTH24_STENCIL8, 4},
+            {GL_DEPTH32F_STENCIL8, 8},
+            #endif
+        };
+        for(UnsignedInt i = UnsignedInt(PixelFormat::R8Unorm); i <= UnsignedInt(PixelFormat::RGBA32F); ++i) {
+            const PixelFormat format = PixelFormat(i);
+            if(!GL::hasTextureFormat(format)) continue;
+            sizes.emplace(GLenum(GL::textureFormat(format)), pixelSize(format));
+        }
+        return sizes;
+    }();
+
+    auto found = sizes.find(format);
+    return found == sizes.end() ? 4 : found->second;
+}
+
+template<UnsignedInt dimensions> std::size_t textureLevelSize(const Math::Vector<dimensions, Int>& size, Int level, std::size_t pixelSize) {
+    return std::size_t(Math::max(size >> level, Math::Vector<dimensions, Int>{1}).product())*pixelSize;
+}
+
+template<UnsignedInt dimensions> void texture(py::class_<GL::Texture<dimensions>, GL::AbstractTexture, GL::PyGLObjectHolder<GL::Texture<dimensions>>>& c) {
     c
         /** @todo limits */
-        .def(py::init(), "Constructor")
+        .def(py::init([]() {
+            auto* texture = new GL::Texture<dimensions>;
+            GL::pyTrackGLObject(texture, GL::PyGLObjectType::Texture, texture->id());
+            return texture;
+        }), "Constructor")
         /** @todo bindImage(), bindImageLayered */
         #ifndef MAGNUM_TARGET_GLES2
         .def_property("base_level", nullptr, &GL::Texture<dimensions>::setBaseLevel, "Base mip level")
@@ -210,7 +300,11 @@ template<UnsignedInt dimensions> void texture(py::class_<GL::Texture<dimensions>
         #endif
         /* Using a lambda to avoid method chaining leaking to Python */
         .def("set_storage", [](GL::Texture<dimensions>& self, Int levels, GL::TextureFormat internalFormat, const typename PyDimensionTraits<dimensions, Int>::VectorType& size) {
+            PyTraceZone zone{"gl", "Texture.set_storage"};
             self.setStorage(levels, internalFormat, size);
+            const std::size_t pixelSize = formatSize(GLenum(internalFormat));
+            for(Int level = 0; level != levels; ++level)
+                GL::pyTrackGLObjectSize(&self, GL::PyGLObjectType::Texture, self.id(), level, textureLevelSize<dimensions>(Math::Vector<dimensions, Int>{size}, level, pixelSize));
         }, "Set storage", py::arg("levels"), py::arg("internal_format"), py::arg("size"))
         #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
         .def("image_size", [](GL::Texture<dimensions>& self, Int level) {
@@ -220,10 +314,13 @@ template<UnsignedInt dimensions> void texture(py::class_<GL::Texture<dimensions>
         /** @todo (compressed/buffer) (sub)image queries */
         /* Using a lambda to avoid method chaining leaking to Python */
         .def("set_image", [](GL::Texture<dimensions>& self, Int level, GL::TextureFormat internalFormat, const BasicImageView<dimensions>& image) {
+            PyTraceZone zone{"gl", "Texture.set_image"};
             self.setImage(level, internalFormat, image);
+            GL::pyTrackGLObjectSize(&self, GL::PyGLObjectType::Texture, self.id(), level, textureLevelSize<dimensions>(Math::Vector<dimensions, Int>{image.size()}, 0, image.pixelSize()));
         }, "Set image data", py::arg("level"), py::arg("internal_format"), py::arg("image"))
         /** @todo compressed/buffer setImage() */
         .def("set_sub_image", [](GL::Texture<dimensions>& self, Int level, const typename PyDimensionTraits<dimensions, Int>::VectorType& offset, const BasicImageView<dimensions>& image) {
+            PyTraceZone zone{"gl", "Texture.set_sub_image"};
             self.setSubImage(level, offset, image);
         }, "Set image subdata", py::arg("level"), py::arg("offset"), py::arg("image"))
         /** @todo compressed/buffer setSubImage() */
@@ -278,6 +375,60 @@ void gl(py::module& m) {
         .def("version", static_cast<std::pair<Int, Int>(*)(GL::Version)>(GL::version), "Major and minor version number from enum value", py::arg("version"))
         .def("is_version_es", GL::isVersionES, "Whether given version is OpenGL ES or WebGL");
 
+    /* Deferred deletion. Initialize the state here so the owning thread is
+       the one that imported the module. */
+    GL::pyDeferredGLObjects();
+    m
+        .def("set_deferred_deletion", [](bool enabled) {
+            GL::pyDeferredGLObjects().enabled = enabled;
+        }, "Enable or disable deferred deletion of GL objects", py::arg("enabled"))
+        .def("deferred_object_count", []() -> std::size_t {
+            return GL::pyDeferredGLObjects().count;
+        }, "Count of GL objects waiting for deletion")
+        .def("delete_deferred_objects", []() {
+            if(!GL::Context::hasCurrent()) {
+                PyErr_SetString(PyExc_RuntimeError, "no context is current");
+                throw py::error_already_set{};
+            }
+            return GL::pyDeleteDeferredGLObjects();
+        }, "Delete GL objects waiting for deletion");
+
+    /* Memory accounting */
+    m
+        .def("memory_usage", []() {
+            std::size_t counts[4]{};
+            std::size_t bytes[4]{};
+            for(const auto& object: GL::pyGLObjectMemory()) {
+                const std::size_t type = std::size_t(object.second.type);
+                ++counts[type];
+                for(const std::size_t size: object.second.levels)
+                    bytes[type] += size;
+            }
+
+            py::dict out;
+            for(std::size_t i = 0; i != 4; ++i) {
+                py::dict usage;
+                usage["count"] = counts[i];
+                usage["bytes"] = bytes[i];
+                out[GLObjectTypeNames[i]] = usage;
+            }
+            return out;
+        }, "Estimated memory used by GL objects of each type")
+        .def("memory_objects", []() {
+            py::list out;
+            for(const auto& object: GL::pyGLObjectMemory()) {
+                std::size_t bytes = 0;
+                for(const std::size_t size: object.second.levels)
+                    bytes += size;
+                py::dict usage;
+                usage["type"] = GLObjectTypeNames[std::size_t(object.second.type)];
+                usage["id"] = object.second.id;
+                usage["bytes"] = bytes;
+                out.append(usage);
+            }
+            return out;
+        }, "Estimated memory used by each GL object");
+
     /* Shader (used by AbstractShaderProgram, so needs to be before) */
     {
         py::class_<GL::Shader> shader{m, "Shader", "Shader"};
@@ -318,8 +469,10 @@ void gl(py::module& m) {
             }, "Compile shader");
     }
 
-    /* Mesh -- needed by AbstractShaderProgram.draw(), so defined earlier */
+    /* Mesh and mesh view -- needed by AbstractShaderProgram.draw(), so
+       defined earlier */
     py::class_<GL::Mesh, GL::PyMeshHolder<GL::Mesh>> mesh{m, "Mesh", "Mesh"};
+    py::class_<GL::MeshView, GL::PyMeshViewHolder<GL::MeshView>> meshView{m, "MeshView", "Mesh view"};
 
     /* Abstract shader program */
     {
@@ -344,6 +497,7 @@ void gl(py::module& m) {
             .def_property_readonly("id", &GL::AbstractShaderProgram::id, "OpenGL program ID")
             .def("validate", &GL::AbstractShaderProgram::validate, "Validate program")
             .def("draw", static_cast<void(GL::AbstractShaderProgram::*)(GL::Mesh&)>(&GL::AbstractShaderProgram::draw), "Draw a mesh")
+            .def("draw", GL::pyMultiDraw, "Draw multiple mesh views at once", py::arg("meshes"))
             #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
             .def("dispatch_compute", &GL::AbstractShaderProgram::dispatchCompute, "Dispatch compute")
             #endif
@@ -501,7 +655,9 @@ void gl(py::module& m) {
         .def_property_readonly("kind", &GL::DynamicAttribute::kind, "Attribute kind")
         .def_property_readonly("location", &GL::DynamicAttribute::location, "Attribute location")
         .def_property_readonly("components", &GL::DynamicAttribute::components, "Component count")
-        .def_property_readonly("data_type", &GL::DynamicAttribute::dataType, "Type of passed data");
+        .def_property_readonly("data_type", &GL::DynamicAttribute::dataType, "Type of passed data")
+        .def_property_readonly("vectors", &GL::DynamicAttribute::vectors, "Count of vectors in this attribute")
+        .def_property_readonly("vector_stride", &GL::DynamicAttribute::vectorStride, "Stride between consecutive vector elements");
 
     /* Buffer */
     py::enum_<GL::BufferUsage>{m, "BufferUsage", "Buffer usage"}
@@ -522,7 +678,7 @@ void gl(py::module& m) {
         #endif
         ;
 
-    py::class_<GL::Buffer> buffer{m, "Buffer", "Buffer"};
+    py::class_<GL::Buffer, GL::PyGLObjectHolder<GL::Buffer>> buffer{m, "Buffer", "Buffer"};
 
     py::enum_<GL::Buffer::TargetHint>{buffer, "TargetHint", "Buffer target"}
         .value("ARRAY", GL::Buffer::TargetHint::Array)
@@ -554,15 +710,42 @@ void gl(py::module& m) {
         #endif
         ;
 
+    #ifndef MAGNUM_TARGET_GLES2
+    py::enum_<GL::Buffer::Target>{buffer, "Target", "Buffer binding target"}
+        #ifndef MAGNUM_TARGET_WEBGL
+        .value("ATOMIC_COUNTER", GL::Buffer::Target::AtomicCounter)
+        .value("SHADER_STORAGE", GL::Buffer::Target::ShaderStorage)
+        #endif
+        .value("UNIFORM", GL::Buffer::Target::Uniform);
+    #endif
+
     buffer
         /** @todo limit queries */
-        .def(py::init<GL::Buffer::TargetHint>(), "Constructor", py::arg("target_hint") = GL::Buffer::TargetHint::Array)
+        .def(py::init([](GL::Buffer::TargetHint targetHint) {
+            auto* buffer = new GL::Buffer{targetHint};
+            GL::pyTrackGLObject(buffer, GL::PyGLObjectType::Buffer, buffer->id());
+            return buffer;
+        }), "Constructor", py::arg("target_hint") = GL::Buffer::TargetHint::Array)
         .def_property_readonly("id", &GL::Buffer::id, "OpenGL buffer ID")
         .def_property("target_hint", &GL::Buffer::targetHint, &GL::Buffer::setTargetHint, "Target hint")
         /* Using lambdas to avoid method chaining getting into signatures */
         .def("set_data", [](GL::Buffer& self, const Containers::ArrayView<const char>& data, GL::BufferUsage usage) {
+            PyTraceZone zone{"gl", "Buffer.set_data"};
             self.setData(data, usage);
+            GL::pyTrackGLObjectSize(&self, GL::PyGLObjectType::Buffer, self.id(), 0, data.size());
         }, "Set buffer data", py::arg("data"), py::arg("usage") = GL::BufferUsage::StaticDraw)
+        .def("set_sub_data", [](GL::Buffer& self, GLintptr offset, const Containers::ArrayView<const char>& data) {
+            PyTraceZone zone{"gl", "Buffer.set_sub_data"};
+            self.setSubData(offset, data);
+        }, "Set buffer subdata", py::arg("offset"), py::arg("data"))
+        #ifndef MAGNUM_TARGET_GLES2
+        .def("bind", [](GL::Buffer& self, GL::Buffer::Target target, UnsignedInt index) {
+            self.bind(target, index);
+        }, "Bind buffer to given binding index", py::arg("target"), py::arg("index"))
+        .def("bind", [](GL::Buffer& self, GL::Buffer::Target target, UnsignedInt index, GLintptr offset, GLsizeiptr size) {
+            self.bind(target, index, offset, size);
+        }, "Bind buffer range to given binding index", py::arg("target"), py::arg("index"), py::arg("offset"), py::arg("size"))
+        #endif
         /** @todo more */;
 
     /* Renderbuffer */
@@ -661,13 +844,23 @@ void gl(py::module& m) {
         #endif
         ;
 
-    py::class_<GL::Renderbuffer>{m, "Renderbuffer", "Renderbuffer"}
+    py::class_<GL::Renderbuffer, GL::PyGLObjectHolder<GL::Renderbuffer>>{m, "Renderbuffer", "Renderbuffer"}
         /** @todo limit queries */
 
-        .def(py::init(), "Constructor")
+        .def(py::init([]() {
+            auto* renderbuffer = new GL::Renderbuffer;
+            GL::pyTrackGLObject(renderbuffer, GL::PyGLObjectType::Renderbuffer, renderbuffer->id());
+            return renderbuffer;
+        }), "Constructor")
         .def_property_readonly("id", &GL::Renderbuffer::id, "OpenGL renderbuffer ID")
-        .def("set_storage", &GL::Renderbuffer::setStorage, "Set renderbuffer storage")
-        .def("set_storage_multisample", &GL::Renderbuffer::setStorageMultisample, "Set multisample renderbuffer storage");
+        .def("set_storage", [](GL::Renderbuffer& self, GL::RenderbufferFormat internalFormat, const Vector2i& size) {
+            self.setStorage(internalFormat, size);
+            GL::pyTrackGLObjectSize(&self, GL::PyGLObjectType::Renderbuffer, self.id(), 0, std::size_t(size.product())*formatSize(GLenum(internalFormat)));
+        }, "Set renderbuffer storage", py::arg("internal_format"), py::arg("size"))
+        .def("set_storage_multisample", [](GL::Renderbuffer& self, Int samples, GL::RenderbufferFormat internalFormat, const Vector2i& size) {
+            self.setStorageMultisample(samples, internalFormat, size);
+            GL::pyTrackGLObjectSize(&self, GL::PyGLObjectType::Renderbuffer, self.id(), 0, std::size_t(samples*size.product())*formatSize(GLenum(internalFormat)));
+        }, "Set multisample renderbuffer storage", py::arg("samples"), py::arg("internal_format"), py::arg("size"));
 
     /* Framebuffers */
     py::enum_<GL::FramebufferClear> framebufferClear{m, "FramebufferClear", "Mask for framebuffer clearing"};
@@ -709,6 +902,19 @@ void gl(py::module& m) {
         }, "Clear specified buffers in the framebuffer")
         .def("read", static_cast<void(GL::AbstractFramebuffer::*)(const Range2Di&, const MutableImageView2D&)>(&GL::AbstractFramebuffer::read), "Read a block of pixels from the framebuffer to an image view", py::arg("rectangle"), py::arg("image"))
         .def("read", static_cast<void(GL::AbstractFramebuffer::*)(const Range2Di&, Image2D&)>(&GL::AbstractFramebuffer::read), "Read a block of pixels from the framebuffer to an image", py::arg("rectangle"), py::arg("image"))
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        .def("read_async", [](GL::AbstractFramebuffer& self, const Range2Di& rectangle, PixelFormat format) {
+            std::shared_ptr<AsyncFramebufferRead> read{new AsyncFramebufferRead{
+                self.read(rectangle, GL::BufferImage2D{format}, GL::BufferUsage::StaticRead),
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+                format,
+                py::module::import("asyncio").attr("get_event_loop")(),
+                {}}};
+            read->future = read->loop.attr("create_future")();
+            pollAsyncFramebufferRead(read);
+            return read->future;
+        }, "Read a block of pixels from the framebuffer asynchronously", py::arg("rectangle"), py::arg("format"))
+        #endif
         /** @todo more */;
 
     py::class_<GL::DefaultFramebuffer, GL::AbstractFramebuffer, NonDefaultFramebufferHolder<GL::DefaultFramebuffer>> defaultFramebuffer{m,
@@ -790,8 +996,16 @@ void gl(py::module& m) {
 
     /* Class definition above AbstractShaderProgram, since that needs it for
        the draw() signature */
-    mesh.def(py::init<GL::MeshPrimitive>(), "Constructor", py::arg("primitive") = GL::MeshPrimitive::Triangles)
-        .def(py::init<MeshPrimitive>(), "Constructor", py::arg("primitive"))
+    mesh.def(py::init([](GL::MeshPrimitive primitive) {
+            auto* mesh = new GL::Mesh{primitive};
+            GL::pyTrackGLObject(mesh, GL::PyGLObjectType::Mesh, mesh->id());
+            return mesh;
+        }), "Constructor", py::arg("primitive") = GL::MeshPrimitive::Triangles)
+        .def(py::init([](MeshPrimitive primitive) {
+            auto* mesh = new GL::Mesh{primitive};
+            GL::pyTrackGLObject(mesh, GL::PyGLObjectType::Mesh, mesh->id());
+            return mesh;
+        }), "Constructor", py::arg("primitive"))
         .def_property_readonly("id", &GL::Mesh::id, "OpenGL vertex array ID")
         .def_property("primitive", &GL::Mesh::primitive,
             [](GL::Mesh& self, py::object primitive) {
@@ -809,6 +1023,9 @@ void gl(py::module& m) {
         .def_property("count", &GL::Mesh::count, [](GL::Mesh& self, UnsignedInt count) {
             self.setCount(count);
         }, "Vertex/index count")
+        .def_property("instance_count", &GL::Mesh::instanceCount, [](GL::Mesh& self, UnsignedInt count) {
+            self.setInstanceCount(count);
+        }, "Instance count")
 
         /* Using lambdas to avoid method chaining getting into signatures */
 
@@ -819,12 +1036,40 @@ void gl(py::module& m) {
                the mesh */
             pyObjectHolderFor<GL::PyMeshHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
         }, "Add vertex buffer", py::arg("buffer"), py::arg("offset"), py::arg("stride"), py::arg("attribute"))
+        .def("add_vertex_buffer_instanced", [](GL::Mesh& self, GL::Buffer& buffer, UnsignedInt divisor, GLintptr offset, GLsizei stride, const GL::DynamicAttribute& attribute) {
+            self.addVertexBufferInstanced(buffer, divisor, offset, stride, attribute);
+
+            /* Keep a reference to the buffer to avoid it being deleted before
+               the mesh */
+            pyObjectHolderFor<GL::PyMeshHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
+        }, "Add instanced vertex buffer", py::arg("buffer"), py::arg("divisor"), py::arg("offset"), py::arg("stride"), py::arg("attribute"))
         /** @todo more */
 
         .def_property_readonly("buffers", [](GL::Mesh& self) {
             return pyObjectHolderFor<GL::PyMeshHolder>(self).buffers;
         }, "Buffer objects referenced by the mesh");
 
+    meshView
+        .def(py::init([](GL::Mesh& mesh) {
+            return GL::PyMeshViewHolder<GL::MeshView>{new GL::MeshView{mesh}, pyObjectFromInstance(mesh)};
+        }), "Constructor", py::arg("mesh"))
+        /* Using lambdas to avoid method chaining getting into signatures */
+        .def_property("count", &GL::MeshView::count, [](GL::MeshView& self, Int count) {
+            self.setCount(count);
+        }, "Vertex/index count")
+        .def_property("base_vertex", &GL::MeshView::baseVertex, [](GL::MeshView& self, Int baseVertex) {
+            self.setBaseVertex(baseVertex);
+        }, "Base vertex")
+        .def("set_index_range", [](GL::MeshView& self, Int first) {
+            self.setIndexRange(first);
+        }, "Set index range", py::arg("first"))
+        .def_property("instance_count", &GL::MeshView::instanceCount, [](GL::MeshView& self, Int count) {
+            self.setInstanceCount(count);
+        }, "Instance count")
+        .def_property_readonly("mesh", [](GL::MeshView& self) {
+            return pyObjectHolderFor<GL::PyMeshViewHolder>(self).mesh;
+        }, "Original mesh");
+
     /* Renderer */
     {
         py::class_<GL::Renderer> renderer{m, "Renderer", "Global renderer configuration"};
@@ -889,6 +1134,8 @@ void gl(py::module& m) {
             .def_static("disable", static_cast<void(*)(GL::Renderer::Feature)>(GL::Renderer::disable), "Disable a feature")
             .def_static("set_feature", static_cast<void(*)(GL::Renderer::Feature, bool)>(GL::Renderer::setFeature), "Enable or disable a feature")
             /** @todo indexed variants */
+            .def_static("flush", GL::Renderer::flush, "Flush the pipeline")
+            .def_static("finish", GL::Renderer::finish, "Finish the pipeline")
 
             /** @todo FFS why do I have to pass the class as first argument?! */
             .def_property_static("clear_color", nullptr, [](py::object, const Color4& color) {
@@ -1069,13 +1316,15 @@ void gl(py::module& m) {
         .def("bind", static_cast<void(GL::AbstractTexture::*)(Int)>(&GL::AbstractTexture::bind), "Bind texture to given texture unit");
 
     #ifndef MAGNUM_TARGET_GLES
-    py::class_<GL::Texture1D, GL::AbstractTexture> texture1D{m, "Texture1D", "One-dimensional texture"};
+    py::class_<GL::Texture1D, GL::AbstractTexture, GL::PyGLObjectHolder<GL::Texture1D>> texture1D{m, "Texture1D", "One-dimensional texture"};
     texture(texture1D);
     #endif
-    py::class_<GL::Texture2D, GL::AbstractTexture> texture2D{m, "Texture2D", "Two-dimensional texture"};
+    py::class_<GL::Texture2D, GL::AbstractTexture, GL::PyGLObjectHolder<GL::Texture2D>> texture2D{m, "Texture2D", "Two-dimensional texture"};
     texture(texture2D);
+    /* Needs Texture2D registered */
+    glTextureStreamer(m);
     #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
-    py::class_<GL::Texture3D, GL::AbstractTexture> texture3D{m, "Texture3D", "Three-dimensional texture"};
+    py::class_<GL::Texture3D, GL::AbstractTexture, GL::PyGLObjectHolder<GL::Texture3D>> texture3D{m, "Texture3D", "Three-dimensional texture"};
     texture(texture3D);
     #endif
 }
@@ -0,0 +1,246 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+
+#include "Magnum/GL/Python.h"
+
+#include "magnum/bootstrap.h"
+
+namespace magnum {
+
+#ifndef MAGNUM_TARGET_GLES2
+namespace {
+
+/* Keeps all mip levels of every texture in memory and makes only a subset of
+   them resident on the GPU. The levels are uploaded one by one, coarsest
+   first, for textures that were used in given frame, and the finest levels
+   of least recently used textures are dropped again to stay under the
+   budget. Dropping a level is done by respecifying it with an empty image
+   and adjusting the base level, which means the texture object itself stays
+   the same and references to it held by Python stay valid. */
+class PyTextureStreamer {
+    public:
+        struct Texture {
+            std::vector<py::object> levels;
+            std::vector<ImageView2D> views;
+            GL::TextureFormat internalFormat;
+            py::object texture;
+            /* Index of the finest resident level, equal to views.size() if
+               nothing is resident */
+            std::size_t residentLevel;
+            /* Frame in which the texture was last used plus one, zero if it
+               was never used */
+            std::size_t lastUsed;
+        };
+
+        explicit PyTextureStreamer(std::size_t budget): _budget{budget} {}
+
+        std::size_t budget() const { return _budget; }
+        void setBudget(std::size_t budget) { _budget = budget; }
+
+        std::size_t frame() const { return _frame; }
+        std::size_t residentBytes() const { return _residentBytes; }
+        std::size_t uploadedBytes() const { return _uploadedBytes; }
+        std::size_t evictedBytes() const { return _evictedBytes; }
+        std::size_t textureCount() const { return _textures.size(); }
+
+        std::size_t add(std::vector<py::object> levels, GL::TextureFormat internalFormat) {
+            if(levels.empty()) {
+                PyErr_SetString(PyExc_ValueError, "expected at least one level");
+                throw py::error_already_set{};
+            }
+
+            Texture t;
+            t.levels = std::move(levels);
+            t.internalFormat = internalFormat;
+            for(std::size_t i = 0; i != t.levels.size(); ++i) {
+                /* This goes through the implicit conversion from
+                   trade.ImageData2D as well. The original objects are kept
+                   alive in the levels array so the views stay valid. */
+                t.views.push_back(py::cast<ImageView2D>(t.levels[i]));
+                const ImageView2D& view = t.views.back();
+
+                const Vector2i expectedSize = Math::max(t.views.front().size() >> Int(i), Vector2i{1});
+                if(view.size() != expectedSize) {
+                    PyErr_Format(PyExc_ValueError, "expected level %zu to have size {%i, %i} but got {%i, %i}", i, expectedSize.x(), expectedSize.y(), view.size().x(), view.size().y());
+                    throw py::error_already_set{};
+                }
+                if(view.format() != t.views.front().format()) {
+                    PyErr_Format(PyExc_ValueError, "expected level %zu to have the same format as level 0", i);
+                    throw py::error_already_set{};
+                }
+            }
+
+            GL::Texture2D texture;
+            texture.setMaxLevel(Int(t.views.size()) - 1);
+            t.texture = py::cast(std::move(texture));
+
+            /* Upload the coarsest level right away so the texture is always
+               usable. This one is never evicted, so it can go over budget. */
+            t.residentLevel = t.views.size();
+            uploadNextLevel(t);
+            t.lastUsed = 0;
+
+            _textures.push_back(std::move(t));
+            return _textures.size() - 1;
+        }
+
+        Texture& at(std::size_t id) {
+            if(id >= _textures.size()) {
+                PyErr_Format(PyExc_IndexError, "index %zu out of range for %zu textures", id, _textures.size());
+                throw py::error_already_set{};
+            }
+            return _textures[id];
+        }
+
+        void use(std::size_t id) {
+            at(id).lastUsed = _frame + 1;
+        }
+
+        std::size_t update(std::size_t uploadBudget) {
+            /* Textures used in this frame that still have levels to upload,
+               smallest pending upload first */
+            std::vector<Texture*> candidates;
+            for(Texture& t: _textures)
+                if(t.lastUsed == _frame + 1 && t.residentLevel) candidates.push_back(&t);
+            std::sort(candidates.begin(), candidates.end(), [](const Texture* a, const Texture* b) {
+                return levelSize(*a, a->residentLevel - 1) < levelSize(*b, b->residentLevel - 1);
+            });
+
+            std::size_t uploaded = 0;
+            for(Texture* t: candidates) {
+                const std::size_t size = levelSize(*t, t->residentLevel - 1);
+                if(uploaded + size > uploadBudget) break;
+                if(!evict(size)) continue;
+                uploadNextLevel(*t);
+                uploaded += size;
+            }
+
+            /* If the budget got lowered, there might be more to evict */
+            evict(0);
+
+            ++_frame;
+            return uploaded;
+        }
+
+    private:
+        static std::size_t levelSize(const Texture& t, std::size_t level) {
+            const ImageView2D& view = t.views[level];
+            return std::size_t(view.size().product())*view.pixelSize();
+        }
+
+        void uploadNextLevel(Texture& t) {
+            const std::size_t level = t.residentLevel - 1;
+            auto& texture = py::cast<GL::Texture2D&>(t.texture);
+            texture.setImage(Int(level), t.internalFormat, t.views[level])
+                .setBaseLevel(Int(level));
+            t.residentLevel = level;
+            const std::size_t size = levelSize(t, level);
+            GL::pyTrackGLObjectSize(&texture, GL::PyGLObjectType::Texture, texture.id(), level, size);
+            _residentBytes += size;
+            _uploadedBytes += size;
+        }
+
+        /* Drops finest levels of textures not used in this frame, least
+           recently used first, until there's enough space for given amount
+           of bytes. Returns false if that's not possible. */
+        bool evict(std::size_t size) {
+            if(_residentBytes + size <= _budget) return true;
+
+            std::vector<Texture*> candidates;
+            for(Texture& t: _textures)
+                if(t.lastUsed != _frame + 1 && t.residentLevel + 1 < t.views.size())
+                    candidates.push_back(&t);
+            std::sort(candidates.begin(), candidates.end(), [](const Texture* a, const Texture* b) {
+                return a->lastUsed < b->lastUsed;
+            });
+
+            for(Texture* t: candidates) {
+                auto& texture = py::cast<GL::Texture2D&>(t->texture);
+                while(t->residentLevel + 1 < t->views.size()) {
+                    const std::size_t level = t->residentLevel;
+                    texture.setBaseLevel(Int(level) + 1)
+                        .setImage(Int(level), t->internalFormat, ImageView2D{t->views[level].format(), Vector2i{}});
+                    t->residentLevel = level + 1;
+                    const std::size_t levelBytes = levelSize(*t, level);
+                    GL::pyTrackGLObjectSize(&texture, GL::PyGLObjectType::Texture, texture.id(), level, 0);
+                    _residentBytes -= levelBytes;
+                    _evictedBytes += levelBytes;
+                    if(_residentBytes + size <= _budget) return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::size_t _budget;
+        std::size_t _frame{};
+        std::size_t _residentBytes{};
+        std::size_t _uploadedBytes{};
+        std::size_t _evictedBytes{};
+        std::vector<Texture> _textures;
+};
+
+}
+#endif
+
+void glTextureStreamer(py::module& m) {
+    #ifndef MAGNUM_TARGET_GLES2
+    py::class_<PyTextureStreamer>{m, "TextureStreamer", "Progressive texture streamer with a memory budget"}
+        .def(py::init<std::size_t>(), "Constructor", py::arg("budget"))
+        .def_property("budget", &PyTextureStreamer::budget, &PyTextureStreamer::setBudget, "Memory budget in bytes")
+        .def_property_readonly("frame", &PyTextureStreamer::frame, "Current frame")
+        .def_property_readonly("resident_bytes", &PyTextureStreamer::residentBytes, "Size of all resident texture levels in bytes")
+        .def_property_readonly("uploaded_bytes", &PyTextureStreamer::uploadedBytes, "Total size of uploaded texture levels in bytes")
+        .def_property_readonly("evicted_bytes", &PyTextureStreamer::evictedBytes, "Total size of evicted texture levels in bytes")
+        .def("__len__", &PyTextureStreamer::textureCount, "Count of textures")
+        .def("add", &PyTextureStreamer::add, "Add a texture", py::arg("levels"), py::arg("internal_format"))
+        .def("texture", [](PyTextureStreamer& self, std::size_t id) {
+            return self.at(id).texture;
+        }, "Texture", py::arg("id"))
+        .def("resident_level", [](PyTextureStreamer& self, std::size_t id) {
+            return self.at(id).residentLevel;
+        }, "Finest resident level of a texture", py::arg("id"))
+        .def("last_used", [](PyTextureStreamer& self, std::size_t id) -> py::object {
+            const std::size_t lastUsed = self.at(id).lastUsed;
+            if(!lastUsed) return py::none{};
+            return py::cast(lastUsed - 1);
+        }, "Frame in which a texture was last used or None if it was never used", py::arg("id"))
+        .def("use", &PyTextureStreamer::use, "Mark a texture as used in current frame", py::arg("id"))
+        .def("update", &PyTextureStreamer::update, "Upload and evict texture levels and advance to next frame", py::arg("upload_budget"));
+    #else
+    static_cast<void>(m);
+    #endif
+}
+
+}
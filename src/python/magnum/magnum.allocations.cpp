@@ -0,0 +1,141 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <pybind11/pybind11.h>
+
+#include "magnum/bootstrap.h"
+
+namespace magnum {
+
+namespace {
+
+/* Allocations done through the Python allocators. Covers Python objects,
+   pybind11 instances and anything else going through PyMem_*() or
+   PyObject_*(). Allocations done with plain malloc() or operator new can't
+   be intercepted from inside an extension module without preloading a
+   library into the interpreter. The raw domain can be used without the GIL,
+   thus atomics. */
+struct AllocationCounters {
+    std::atomic<std::size_t> allocations{};
+    std::atomic<std::size_t> objects{};
+    std::atomic<std::size_t> reallocations{};
+    std::atomic<std::size_t> deallocations{};
+    std::atomic<std::size_t> bytes{};
+};
+
+struct CountingAllocator {
+    PyMemAllocatorDomain domain;
+    PyMemAllocatorEx original;
+};
+
+AllocationCounters counters;
+CountingAllocator allocators[]{
+    {PYMEM_DOMAIN_RAW, {}},
+    {PYMEM_DOMAIN_MEM, {}},
+    {PYMEM_DOMAIN_OBJ, {}}
+};
+bool counting = false;
+
+void countAllocation(const CountingAllocator& allocator, std::size_t size) {
+    ++(allocator.domain == PYMEM_DOMAIN_OBJ ? counters.objects : counters.allocations);
+    counters.bytes += size;
+}
+
+void* countingMalloc(void* context, std::size_t size) {
+    const CountingAllocator& allocator = *static_cast<CountingAllocator*>(context);
+    countAllocation(allocator, size);
+    return allocator.original.malloc(allocator.original.ctx, size);
+}
+
+void* countingCalloc(void* context, std::size_t count, std::size_t size) {
+    const CountingAllocator& allocator = *static_cast<CountingAllocator*>(context);
+    countAllocation(allocator, count*size);
+    return allocator.original.calloc(allocator.original.ctx, count, size);
+}
+
+void* countingRealloc(void* context, void* pointer, std::size_t size) {
+    const CountingAllocator& allocator = *static_cast<CountingAllocator*>(context);
+    if(pointer) {
+        ++counters.reallocations;
+        counters.bytes += size;
+    } else countAllocation(allocator, size);
+    return allocator.original.realloc(allocator.original.ctx, pointer, size);
+}
+
+void countingFree(void* context, void* pointer) {
+    const CountingAllocator& allocator = *static_cast<CountingAllocator*>(context);
+    if(pointer) ++counters.deallocations;
+    allocator.original.free(allocator.original.ctx, pointer);
+}
+
+}
+
+void allocations(py::module& m) {
+    /* Used by the test suite to assert allocation budgets of hot calls, see
+       AllocationCounter in test/__init__.py. Blocks allocated while counting
+       can be freed after the original allocators are restored and vice
+       versa, as the counting ones only forward. */
+    m
+        .def("_start_allocation_counting", []() {
+            if(counting) {
+                PyErr_SetString(PyExc_RuntimeError, "allocation counting is already active");
+                throw py::error_already_set{};
+            }
+
+            counters.allocations = 0;
+            counters.objects = 0;
+            counters.reallocations = 0;
+            counters.deallocations = 0;
+            counters.bytes = 0;
+            for(CountingAllocator& allocator: allocators) {
+                PyMem_GetAllocator(allocator.domain, &allocator.original);
+                PyMemAllocatorEx wrapper{&allocator, countingMalloc, countingCalloc, countingRealloc, countingFree};
+                PyMem_SetAllocator(allocator.domain, &wrapper);
+            }
+            counting = true;
+        })
+        .def("_stop_allocation_counting", []() {
+            if(!counting) {
+                PyErr_SetString(PyExc_RuntimeError, "allocation counting is not active");
+                throw py::error_already_set{};
+            }
+
+            for(CountingAllocator& allocator: allocators)
+                PyMem_SetAllocator(allocator.domain, &allocator.original);
+            counting = false;
+
+            /* Created after the allocators are restored so it's not counted */
+            py::dict out;
+            out["allocations"] = std::size_t(counters.allocations);
+            out["objects"] = std::size_t(counters.objects);
+            out["reallocations"] = std::size_t(counters.reallocations);
+            out["deallocations"] = std::size_t(counters.deallocations);
+            out["bytes"] = std::size_t(counters.bytes);
+            return out;
+        });
+}
+
+}
@@ -342,6 +342,11 @@ PYBIND11_MODULE(_magnum, m) {
 
     /* These need stuff from math, so need to be called after */
     magnum::magnum(m);
+    magnum::resourceManager(m);
+    magnum::threadPool(m);
+    magnum::tracing(m);
+    magnum::allocations(m);
+    magnum::cpu(m);
 
     /* In case Magnum is a bunch of static libraries, put everything into a
        single shared lib to make it easier to install (which is the point of
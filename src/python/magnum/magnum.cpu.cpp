@@ -0,0 +1,141 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/ArrayView.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/cpu.h"
+
+#ifdef MAGNUM_PY_CPU_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace magnum {
+
+namespace {
+
+const char* CpuLevelNames[]{
+    "scalar",
+    "sse2",
+    "avx2",
+    "avx512",
+    "neon"
+};
+
+#ifdef MAGNUM_PY_CPU_X86
+void cpuid(UnsignedInt leaf, UnsignedInt (&out)[4]) {
+    #ifdef _MSC_VER
+    int regs[4];
+    __cpuidex(regs, leaf, 0);
+    for(std::size_t i = 0; i != 4; ++i) out[i] = regs[i];
+    #else
+    if(!__get_cpuid_count(leaf, 0, &out[0], &out[1], &out[2], &out[3]))
+        out[0] = out[1] = out[2] = out[3] = 0;
+    #endif
+}
+
+/* Which register state the OS saves on context switch. Without that the
+   instructions are present, but using the wider registers would corrupt
+   them. */
+UnsignedLong xgetbv() {
+    #ifdef _MSC_VER
+    return _xgetbv(0);
+    #else
+    UnsignedInt eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (UnsignedLong(edx) << 32)|eax;
+    #endif
+}
+#endif
+
+PyCpuLevel detectCpuLevel() {
+    #ifdef MAGNUM_PY_CPU_X86
+    UnsignedInt leaf0[4], leaf1[4], leaf7[4];
+    cpuid(0, leaf0);
+    cpuid(1, leaf1);
+    if(leaf0[0] >= 7) cpuid(7, leaf7);
+    else leaf7[0] = leaf7[1] = leaf7[2] = leaf7[3] = 0;
+
+    /* SSE2 */
+    if(!(leaf1[3] & (1 << 26))) return PyCpuLevel::Scalar;
+
+    /* OSXSAVE, AVX and FMA */
+    if((leaf1[2] & (1 << 27)) && (leaf1[2] & (1 << 28)) && (leaf1[2] & (1 << 12))) {
+        const UnsignedLong xcr0 = xgetbv();
+        /* XMM and YMM state, AVX2 */
+        if((xcr0 & 0x06) == 0x06 && (leaf7[1] & (1 << 5))) {
+            /* Opmask and ZMM state, AVX512F, DQ, BW and VL */
+            if((xcr0 & 0xe6) == 0xe6 &&
+               (leaf7[1] & (1u << 16)) && (leaf7[1] & (1u << 17)) &&
+               (leaf7[1] & (1u << 30)) && (leaf7[1] & (1u << 31)))
+                return PyCpuLevel::Avx512;
+            return PyCpuLevel::Avx2;
+        }
+    }
+    return PyCpuLevel::Sse2;
+    #elif defined(MAGNUM_PY_CPU_NEON)
+    return PyCpuLevel::Neon;
+    #else
+    return PyCpuLevel::Scalar;
+    #endif
+}
+
+}
+
+void cpu(py::module& m) {
+    /* The environment variable can only lower the detected level, mainly
+       for testing the fallbacks. Levels from a different architecture
+       result in the scalar code being used. */
+    PyCpuLevel level = detectCpuLevel();
+    if(const char* const override = std::getenv("MAGNUM_CPU_DISPATCH")) {
+        std::size_t i = 0;
+        for(; i != Containers::arraySize(CpuLevelNames); ++i)
+            if(std::strcmp(override, CpuLevelNames[i]) == 0) break;
+        if(i == Containers::arraySize(CpuLevelNames)) {
+            PyErr_Format(PyExc_ValueError, "unknown MAGNUM_CPU_DISPATCH value %s", override);
+            throw py::error_already_set{};
+        }
+
+        const PyCpuLevel requested = PyCpuLevel(i);
+        const bool sameArchitecture = (requested == PyCpuLevel::Neon) == (level == PyCpuLevel::Neon);
+        if(requested == PyCpuLevel::Scalar || !sameArchitecture)
+            level = PyCpuLevel::Scalar;
+        else if(UnsignedInt(requested) < UnsignedInt(level))
+            level = requested;
+    }
+
+    /* Other modules get the level through this, see pyCpuLevel() */
+    m.attr("_cpu_level") = UnsignedInt(level);
+    m.attr("CPU_DISPATCH") = CpuLevelNames[UnsignedInt(level)];
+}
+
+}
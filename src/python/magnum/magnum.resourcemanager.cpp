@@ -0,0 +1,265 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <unordered_map>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/AbstractResourceLoader.h>
+#include <Magnum/ResourceManager.h>
+
+#include "magnum/bootstrap.h"
+
+namespace magnum {
+
+namespace {
+
+/* All resources are stored as Python objects, which means a single manager
+   can hold meshes, textures, shaders and imported data at the same time.
+   That's the Python equivalent of the variadic type list on the C++ side. */
+typedef ResourceManager<py::object> ObjectResourceManager;
+typedef AbstractResourceLoader<py::object> ObjectResourceLoader;
+
+struct PyResourceLoader;
+
+/* ResourceKey is just a hash, so remember the original string for every key
+   that went through the manager in order to be able to pass it to loaders
+   and to check references in clear() */
+struct PyResourceManager: ObjectResourceManager {
+    ResourceKey key(const std::string& name) {
+        ResourceKey key{name};
+        names.emplace(key.hexString(), name);
+        return key;
+    }
+
+    std::string name(ResourceKey key) const {
+        auto found = names.find(key.hexString());
+        return found == names.end() ? std::string{} : found->second;
+    }
+
+    std::unordered_map<std::string, std::string> names;
+    /* Owned by ObjectResourceManager, kept here to make it available to
+       Python */
+    PyResourceLoader* loader{};
+};
+
+/* Python-facing loader. Can't be the AbstractResourceLoader itself as the
+   manager takes ownership of it while here its lifetime is controlled by
+   Python, so the manager gets a forwarding instance instead. */
+struct PyResourceLoader {
+    struct Forwarder;
+
+    virtual ~PyResourceLoader() = default;
+
+    virtual void doLoad(const std::string& key) = 0;
+
+    Forwarder* forwarder{};
+};
+
+struct PyResourceLoader::Forwarder: ObjectResourceLoader {
+    explicit Forwarder(PyResourceManager& manager, py::object loader): manager(manager), loader{std::move(loader)} {
+        py::cast<PyResourceLoader&>(this->loader).forwarder = this;
+    }
+
+    ~Forwarder() {
+        py::cast<PyResourceLoader&>(loader).forwarder = nullptr;
+    }
+
+    using ObjectResourceLoader::set;
+    using ObjectResourceLoader::setNotFound;
+
+    std::string doName(ResourceKey key) const override {
+        return manager.name(key);
+    }
+
+    void doLoad(ResourceKey key) override {
+        py::cast<PyResourceLoader&>(loader).doLoad(manager.name(key));
+    }
+
+    PyResourceManager& manager;
+    py::object loader;
+};
+
+struct PyResourceLoaderTrampoline: PyResourceLoader {
+    void doLoad(const std::string& key) override {
+        PYBIND11_OVERLOAD_PURE_NAME(
+            void,
+            PyResourceLoader,
+            "do_load",
+            doLoad,
+            key
+        );
+    }
+};
+
+/* Resource itself has only the key hash, remember the name as well */
+struct PyResource {
+    Resource<py::object> resource;
+    std::string key;
+};
+
+void checkDataState(const py::object& data, ResourceDataState state) {
+    if(data.is_none() != (state == ResourceDataState::NotFound || state == ResourceDataState::Loading)) {
+        PyErr_SetString(PyExc_ValueError, "data should be None if and only if state is NOT_FOUND or LOADING");
+        throw py::error_already_set{};
+    }
+}
+
+void checkNotFinal(ResourceState state) {
+    if(state == ResourceState::Final) {
+        PyErr_SetString(PyExc_RuntimeError, "cannot change an already final resource");
+        throw py::error_already_set{};
+    }
+}
+
+}
+
+void resourceManager(py::module& m) {
+    py::enum_<ResourceState>{m, "ResourceState", "Resource state"}
+        .value("NOT_LOADED", ResourceState::NotLoaded)
+        .value("NOT_LOADED_FALLBACK", ResourceState::NotLoadedFallback)
+        .value("LOADING", ResourceState::Loading)
+        .value("LOADING_FALLBACK", ResourceState::LoadingFallback)
+        .value("NOT_FOUND", ResourceState::NotFound)
+        .value("NOT_FOUND_FALLBACK", ResourceState::NotFoundFallback)
+        .value("MUTABLE", ResourceState::Mutable)
+        .value("FINAL", ResourceState::Final);
+
+    py::enum_<ResourceDataState>{m, "ResourceDataState", "Resource data state"}
+        .value("LOADING", ResourceDataState::Loading)
+        .value("NOT_FOUND", ResourceDataState::NotFound)
+        .value("MUTABLE", ResourceDataState::Mutable)
+        .value("FINAL", ResourceDataState::Final);
+
+    py::enum_<ResourcePolicy>{m, "ResourcePolicy", "Resource policy"}
+        .value("RESIDENT", ResourcePolicy::Resident)
+        .value("MANUAL", ResourcePolicy::Manual)
+        .value("REFERENCE_COUNTED", ResourcePolicy::ReferenceCounted);
+
+    py::class_<PyResource>{m, "Resource", "Resource reference"}
+        .def_property_readonly("key", [](const PyResource& self) {
+            return self.key;
+        }, "Resource key")
+        .def_property_readonly("state", [](PyResource& self) {
+            return self.resource.state();
+        }, "Resource state")
+        .def_property_readonly("data", [](PyResource& self) -> py::object {
+            py::object* data = self.resource;
+            return data ? *data : py::none{};
+        }, "Resource data or a fallback")
+        .def("__bool__", [](PyResource& self) {
+            return !!self.resource;
+        }, "Whether the data or a fallback are available");
+
+    py::class_<PyResourceLoader, PyResourceLoaderTrampoline>{m, "AbstractResourceLoader", "Base for resource loaders"}
+        .def(py::init_alias<>(), "Constructor")
+        .def_property_readonly("requested_count", [](PyResourceLoader& self) -> std::size_t {
+            return self.forwarder ? self.forwarder->requestedCount() : 0;
+        }, "Count of resources requested by calling load()")
+        .def_property_readonly("loaded_count", [](PyResourceLoader& self) -> std::size_t {
+            return self.forwarder ? self.forwarder->loadedCount() : 0;
+        }, "Count of loaded resources")
+        .def_property_readonly("not_found_count", [](PyResourceLoader& self) -> std::size_t {
+            return self.forwarder ? self.forwarder->notFoundCount() : 0;
+        }, "Count of resources requested by calling load(), but not found by the loader")
+        .def("set", [](PyResourceLoader& self, const std::string& key, py::object data, ResourceDataState state, ResourcePolicy policy) {
+            if(!self.forwarder) {
+                PyErr_SetString(PyExc_RuntimeError, "the loader is not set for any manager");
+                throw py::error_already_set{};
+            }
+            checkDataState(data, state);
+            PyResourceManager& manager = self.forwarder->manager;
+            const ResourceKey resourceKey = manager.key(key);
+            checkNotFinal(manager.state<py::object>(resourceKey));
+            self.forwarder->set(resourceKey, data.is_none() ? nullptr : new py::object{std::move(data)}, state, policy);
+        }, "Set loaded resource to the manager", py::arg("key"), py::arg("data"), py::arg("state") = ResourceDataState::Final, py::arg("policy") = ResourcePolicy::Resident)
+        .def("set_not_found", [](PyResourceLoader& self, const std::string& key) {
+            if(!self.forwarder) {
+                PyErr_SetString(PyExc_RuntimeError, "the loader is not set for any manager");
+                throw py::error_already_set{};
+            }
+            self.forwarder->setNotFound(self.forwarder->manager.key(key));
+        }, "Mark resource as not found")
+        .def("do_load", &PyResourceLoader::doLoad, "Implementation for load()");
+
+    py::class_<PyResourceManager>{m, "ResourceManager", "Resource manager"}
+        .def(py::init(), "Constructor")
+        .def_property_readonly("count", [](PyResourceManager& self) {
+            return self.count<py::object>();
+        }, "Count of resources")
+        .def("state", [](PyResourceManager& self, const std::string& key) {
+            return self.state<py::object>(self.key(key));
+        }, "Resource state")
+        .def("reference_count", [](PyResourceManager& self, const std::string& key) {
+            return self.referenceCount<py::object>(self.key(key));
+        }, "Reference count of given resource")
+        .def("get", [](PyResourceManager& self, const std::string& key) {
+            return PyResource{self.get<py::object>(self.key(key)), key};
+        }, "Get resource reference", py::keep_alive<0, 1>())
+        .def("set", [](PyResourceManager& self, const std::string& key, py::object data, ResourceDataState state, ResourcePolicy policy) {
+            checkDataState(data, state);
+            const ResourceKey resourceKey = self.key(key);
+            checkNotFinal(self.state<py::object>(resourceKey));
+            self.set<py::object>(resourceKey, data.is_none() ? nullptr : new py::object{std::move(data)}, state, policy);
+        }, "Set resource data", py::arg("key"), py::arg("data"), py::arg("state") = ResourceDataState::Final, py::arg("policy") = ResourcePolicy::Resident)
+        .def_property("fallback", [](PyResourceManager& self) -> py::object {
+            py::object* fallback = self.fallback<py::object>();
+            return fallback ? *fallback : py::none{};
+        }, [](PyResourceManager& self, py::object fallback) {
+            self.setFallback<py::object>(fallback.is_none() ? nullptr : new py::object{std::move(fallback)});
+        }, "Fallback for not found resources")
+        .def_property("loader", [](PyResourceManager& self) -> py::object {
+            return self.loader ? self.loader->forwarder->loader : py::none{};
+        }, [](PyResourceManager& self, py::object loader) {
+            if(loader.is_none()) {
+                self.setLoader<py::object>(nullptr);
+                self.loader = nullptr;
+                return;
+            }
+
+            PyResourceLoader& pyLoader = py::cast<PyResourceLoader&>(loader);
+            if(pyLoader.forwarder) {
+                PyErr_SetString(PyExc_RuntimeError, "the loader is already set for a manager");
+                throw py::error_already_set{};
+            }
+            /* The forwarder is owned by the manager from now on, the previous
+               one (if any) gets deleted here */
+            self.setLoader<py::object>(Containers::pointer<PyResourceLoader::Forwarder>(self, std::move(loader)));
+            self.loader = &pyLoader;
+        }, "Resource loader")
+        .def("free", [](PyResourceManager& self) {
+            self.free<py::object>();
+        }, "Free all resources that are not referenced")
+        .def("clear", [](PyResourceManager& self) {
+            for(const auto& name: self.names) {
+                if(self.referenceCount<py::object>(ResourceKey{name.second})) {
+                    PyErr_Format(PyExc_RuntimeError, "resource %s is still referenced", name.second.data());
+                    throw py::error_already_set{};
+                }
+            }
+            self.clear<py::object>();
+        }, "Clear all resources");
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <pybind11/pybind11.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/threadpool.h"
+
+namespace magnum {
+
+namespace {
+
+/* Created on first use and never destroyed, as joining threads during
+   interpreter shutdown is asking for trouble */
+PyThreadPool& sharedThreadPool() {
+    static PyThreadPool* pool = new PyThreadPool;
+    return *pool;
+}
+
+}
+
+void threadPool(py::module& m) {
+    /* Other modules get the instance through this, see pyThreadPool() */
+    m.attr("_thread_pool") = py::capsule{&sharedThreadPool()};
+
+    m
+        .def("set_thread_count", [](std::size_t count, bool pinThreads) {
+            sharedThreadPool().setThreadCount(count, pinThreads);
+        }, "Set thread count of the shared thread pool", py::arg("count") = 0, py::arg("pin_threads") = false)
+        .def("thread_count", []() {
+            return sharedThreadPool().threadCount();
+        }, "Thread count of the shared thread pool")
+        .def("set_grain_size", [](std::size_t size) {
+            sharedThreadPool().setGrainSize(size);
+        }, "Set minimal count of items processed by a single task", py::arg("size"))
+        .def("grain_size", []() {
+            return sharedThreadPool().grainSize();
+        }, "Minimal count of items processed by a single task")
+        .def("thread_pool_stats", []() {
+            PyThreadPool& pool = sharedThreadPool();
+            const PyThreadPool::Stats& stats = pool.stats();
+            const std::chrono::steady_clock::rep busyTime = stats.busyTime;
+            const std::chrono::steady_clock::rep availableTime = stats.availableTime;
+
+            py::dict out;
+            out["thread_count"] = pool.threadCount();
+            out["regions"] = std::size_t(stats.regions);
+            out["serial_regions"] = std::size_t(stats.serialRegions);
+            out["nested_regions"] = std::size_t(stats.nestedRegions);
+            out["tasks"] = std::size_t(stats.tasks);
+            out["steals"] = std::size_t(stats.steals);
+            out["queue_depth"] = pool.queueDepth();
+            out["max_queue_depth"] = std::size_t(stats.maxQueueDepth);
+            out["busy_time"] = std::chrono::duration<Double>{std::chrono::steady_clock::duration{busyTime}}.count();
+            out["utilization"] = availableTime ? Double(busyTime)/Double(availableTime) : 0.0;
+            return out;
+        }, "Shared thread pool statistics")
+        .def("reset_thread_pool_stats", []() {
+            sharedThreadPool().resetStats();
+        }, "Reset shared thread pool statistics");
+}
+
+}
@@ -0,0 +1,164 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <pybind11/pybind11.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/tracing.h"
+
+namespace magnum {
+
+namespace {
+
+/* Never destroyed so zones ending during interpreter shutdown don't access
+   a dead instance */
+PyTracer& sharedTracer() {
+    static PyTracer* tracer = new PyTracer;
+    return *tracer;
+}
+
+/* Zone entered from Python through a context manager */
+struct PyTraceZoneContext {
+    std::string name;
+    const char* category;
+    std::chrono::steady_clock::time_point begin;
+};
+
+void writeJsonString(std::ostream& out, const std::string& string) {
+    out << '"';
+    for(const char c: string) {
+        if(c == '"' || c == '\\') out << '\\' << c;
+        else if(c == '\n') out << "\\n";
+        else if(UnsignedByte(c) < 0x20) {
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", UnsignedInt(UnsignedByte(c)));
+            out << escaped;
+        } else out << c;
+    }
+    out << '"';
+}
+
+/* Chrome trace event format, loadable in chrome://tracing and Perfetto UI.
+   Thread IDs are replaced with small integers in order of appearance and
+   times are relative to the earliest event. */
+std::string chromeTrace(const std::vector<PyTraceEvent>& events) {
+    std::chrono::steady_clock::time_point origin = events.empty() ? std::chrono::steady_clock::time_point{} : events.front().begin;
+    for(const PyTraceEvent& event: events)
+        if(event.begin < origin) origin = event.begin;
+
+    std::map<std::thread::id, std::size_t> threads;
+    std::ostringstream out;
+    out << "{\"traceEvents\":[";
+    for(std::size_t i = 0; i != events.size(); ++i) {
+        const PyTraceEvent& event = events[i];
+        const std::size_t thread = threads.emplace(event.thread, threads.size()).first->second;
+        if(i) out << ',';
+        out << "\n{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":"
+            << std::chrono::duration<Double, std::micro>{event.begin - origin}.count()
+            << ",\"dur\":"
+            << std::chrono::duration<Double, std::micro>{event.duration}.count()
+            << ",\"pid\":0,\"tid\":" << thread << '}';
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+}
+
+void tracing(py::module& m) {
+    /* Other modules get the instance through this, see pyTracer() */
+    m.attr("_tracer") = py::capsule{&sharedTracer()};
+
+    py::class_<PyTraceZoneContext>{m, "TraceZone", "Trace zone"}
+        .def(py::init([](const std::string& name, const std::string& category) {
+            /* Categories are stored as pointers, intern the few distinct
+               ones Python code uses */
+            static std::map<std::string, std::string> categories;
+            const char* interned = categories.emplace(category, category).first->second.data();
+            return PyTraceZoneContext{name, interned, {}};
+        }), "Constructor", py::arg("name"), py::arg("category") = "python")
+        .def("__enter__", [](PyTraceZoneContext& self) {
+            self.begin = std::chrono::steady_clock::now();
+        }, "Enter the zone")
+        .def("__exit__", [](PyTraceZoneContext& self, py::object, py::object, py::object) {
+            PyTracer& tracer = sharedTracer();
+            if(tracer.isEnabled())
+                tracer.add(self.name, self.category, self.begin, std::chrono::steady_clock::now());
+        }, "Exit the zone");
+
+    m
+        .def("set_tracing", [](bool enabled) {
+            sharedTracer().setEnabled(enabled);
+        }, "Enable or disable tracing", py::arg("enabled"))
+        .def("is_tracing", []() {
+            return sharedTracer().isEnabled();
+        }, "Whether tracing is enabled")
+        .def("trace_events", []() {
+            py::list out;
+            for(const PyTraceEvent& event: sharedTracer().events()) {
+                py::dict e;
+                e["name"] = event.name;
+                e["category"] = event.category;
+                e["duration"] = std::chrono::duration<Double>{event.duration}.count();
+                out.append(e);
+            }
+            return out;
+        }, "Recorded trace events")
+        .def("save_trace", [](const std::string& filename) {
+            std::ofstream file{filename, std::ios::binary};
+            if(!file) {
+                PyErr_Format(PyExc_RuntimeError, "cannot open %s for writing", filename.data());
+                throw py::error_already_set{};
+            }
+            file << chromeTrace(sharedTracer().events());
+        }, "Save recorded events in the Chrome trace format", py::arg("filename"))
+        .def("clear_trace", []() {
+            sharedTracer().clear();
+        }, "Clear recorded trace events")
+        .def("set_trampoline_counters", [](bool enabled) {
+            sharedTracer().setCountingTrampolines(enabled);
+        }, "Enable or disable counting of calls into Python overrides", py::arg("enabled"))
+        .def("trampoline_stats", []() {
+            py::dict out;
+            for(const auto& stats: sharedTracer().trampolineStats()) {
+                py::dict s;
+                s["calls"] = stats.second.calls;
+                s["time"] = std::chrono::duration<Double>{stats.second.time}.count();
+                out[py::str{stats.first}] = s;
+            }
+            return out;
+        }, "Calls into Python overrides")
+        .def("reset_trampoline_stats", []() {
+            sharedTracer().resetTrampolineStats();
+        }, "Reset counters of calls into Python overrides");
+}
+
+}
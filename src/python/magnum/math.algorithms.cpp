@@ -0,0 +1,345 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstring>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Algorithms/GaussJordan.h>
+#include <Magnum/Math/Algorithms/GramSchmidt.h>
+#include <Magnum/Math/Algorithms/Qr.h>
+#include <Magnum/Math/Algorithms/Svd.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/cpu.h"
+#include "magnum/threadpool.h"
+
+namespace magnum {
+
+namespace {
+
+template<class VectorType> void algorithms(py::module& m) {
+    typedef typename VectorType::Type T;
+    typedef Math::Matrix<VectorType::Size, T> MatrixType;
+
+    m
+        .def("svd", [](const MatrixType& matrix) {
+            const auto usv = Math::Algorithms::svd(matrix);
+            return std::make_tuple(MatrixType{std::get<0>(usv)}, VectorType{std::get<1>(usv)}, std::get<2>(usv));
+        }, "Singular value decomposition", py::arg("matrix"))
+        .def("qr", [](const MatrixType& matrix) {
+            return Math::Algorithms::qr(matrix);
+        }, "QR decomposition", py::arg("matrix"))
+        .def("gram_schmidt_orthogonalize", [](const MatrixType& matrix) {
+            return MatrixType{Math::Algorithms::gramSchmidtOrthogonalize(matrix)};
+        }, "Gram-Schmidt matrix orthogonalization", py::arg("matrix"))
+        .def("gram_schmidt_orthonormalize", [](const MatrixType& matrix) {
+            return MatrixType{Math::Algorithms::gramSchmidtOrthonormalize(matrix)};
+        }, "Gram-Schmidt matrix orthonormalization", py::arg("matrix"))
+        .def("gauss_jordan_inverted", [](const MatrixType& matrix) {
+            /* Math::Algorithms::gaussJordanInverted() asserts on singular
+               matrices, do the elimination directly to be able to raise */
+            Math::RectangularMatrix<VectorType::Size, VectorType::Size, T> a = matrix;
+            Math::RectangularMatrix<VectorType::Size, VectorType::Size, T> inverted = MatrixType{Math::IdentityInit};
+            if(!Math::Algorithms::gaussJordanInPlace(a, inverted)) {
+                PyErr_SetString(PyExc_ValueError, "the matrix is singular");
+                throw py::error_already_set{};
+            }
+            return MatrixType{inverted};
+        }, "Inverted matrix using Gauss-Jordan elimination", py::arg("matrix"));
+}
+
+/* A batch of square matrices in a buffer of (n, size, size) items, indexed
+   as [matrix][row][column] like np.array(Matrix3x3). The formats string lists
+   accepted format characters, formatName is used in the error message. */
+void matrices(py::buffer matrices, Py_buffer& buffer, Py_ssize_t size, const char* formats, const char* formatName, bool writable) {
+    if(PyObject_GetBuffer(matrices.ptr(), &buffer, PyBUF_STRIDES|PyBUF_FORMAT|(writable ? PyBUF_WRITABLE : 0)) != 0)
+        throw py::error_already_set{};
+
+    if(buffer.ndim != 3) {
+        PyErr_Format(PyExc_BufferError, "expected 3 dimensions but got %i", buffer.ndim);
+        PyBuffer_Release(&buffer);
+        throw py::error_already_set{};
+    }
+    if(buffer.shape[1] != size || buffer.shape[2] != size) {
+        PyErr_Format(PyExc_BufferError, "expected a shape of (n, %zi, %zi) but got (%zi, %zi, %zi)", size, size, buffer.shape[0], buffer.shape[1], buffer.shape[2]);
+        PyBuffer_Release(&buffer);
+        throw py::error_already_set{};
+    }
+
+    /* Native byte order only */
+    const char* format = buffer.format ? buffer.format : "B";
+    if(*format == '@' || *format == '=') ++format;
+    if(!*format || !std::strchr(formats, *format) || format[1]) {
+        PyErr_Format(PyExc_BufferError, "expected a %s format but got %s", formatName, buffer.format);
+        PyBuffer_Release(&buffer);
+        throw py::error_already_set{};
+    }
+}
+
+bool isDouble(const Py_buffer& buffer) {
+    return buffer.format[std::strlen(buffer.format) - 1] == 'd';
+}
+
+template<class T> Matrix3x3d readMatrix3x3(const Py_buffer& buffer, std::size_t i) {
+    const char* const data = static_cast<const char*>(buffer.buf) + i*buffer.strides[0];
+    Matrix3x3d out{Math::NoInit};
+    for(std::size_t row = 0; row != 3; ++row)
+        for(std::size_t col = 0; col != 3; ++col)
+            out[col][row] = *reinterpret_cast<const T*>(data + row*buffer.strides[1] + col*buffer.strides[2]);
+    return out;
+}
+
+template<class T> void writeMatrix3x3(const Py_buffer& buffer, std::size_t i, const Matrix3x3d& matrix) {
+    char* const data = static_cast<char*>(buffer.buf) + i*buffer.strides[0];
+    for(std::size_t row = 0; row != 3; ++row)
+        for(std::size_t col = 0; col != 3; ++col)
+            *reinterpret_cast<T*>(data + row*buffer.strides[1] + col*buffer.strides[2]) = T(matrix[col][row]);
+}
+
+/* Eigenvector of the largest eigenvalue of a symmetric 4x4 matrix using
+   cyclic Jacobi rotations. Converges in a handful of sweeps for matrices this
+   small and unlike a general SVD needs no allocations or pivoting. */
+Vector4d largestEigenvector(Matrix4x4d a) {
+    Matrix4x4d v{Math::IdentityInit};
+    for(std::size_t sweep = 0; sweep != 16; ++sweep) {
+        Double off = 0.0;
+        for(std::size_t p = 0; p != 4; ++p)
+            for(std::size_t q = p + 1; q != 4; ++q)
+                off += a[q][p]*a[q][p];
+        if(off < 1.0e-30) break;
+
+        for(std::size_t p = 0; p != 4; ++p) {
+            for(std::size_t q = p + 1; q != 4; ++q) {
+                if(a[q][p] == 0.0) continue;
+
+                const Double theta = (a[q][q] - a[p][p])/(2.0*a[q][p]);
+                const Double t = (theta >= 0.0 ? 1.0 : -1.0)/(std::abs(theta) + std::sqrt(theta*theta + 1.0));
+                const Double c = 1.0/std::sqrt(t*t + 1.0);
+                const Double s = t*c;
+
+                for(std::size_t k = 0; k != 4; ++k) {
+                    const Double akp = a[p][k], akq = a[q][k];
+                    a[p][k] = c*akp - s*akq;
+                    a[q][k] = s*akp + c*akq;
+                }
+                for(std::size_t k = 0; k != 4; ++k) {
+                    const Double apk = a[k][p], aqk = a[k][q];
+                    a[k][p] = c*apk - s*aqk;
+                    a[k][q] = s*apk + c*aqk;
+                }
+                for(std::size_t k = 0; k != 4; ++k) {
+                    const Double vkp = v[p][k], vkq = v[q][k];
+                    v[p][k] = c*vkp - s*vkq;
+                    v[q][k] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+
+    std::size_t largest = 0;
+    for(std::size_t i = 1; i != 4; ++i)
+        if(a[i][i] > a[largest][largest]) largest = i;
+    return v[largest];
+}
+
+/* Rotation minimizing the distance between rotated source points a_i and
+   target points b_i, given their cross-covariance h = sum(a_i b_i^T) with
+   h[col][row] indexing. Uses Horn's quaternion formulation, which always
+   gives a proper rotation, without the reflection fixup needed by the SVD
+   formulation. */
+Matrix3x3d kabsch(const Matrix3x3d& h) {
+    const Double xx = h[0][0], xy = h[1][0], xz = h[2][0],
+                 yx = h[0][1], yy = h[1][1], yz = h[2][1],
+                 zx = h[0][2], zy = h[1][2], zz = h[2][2];
+    const Vector4d q = largestEigenvector(Matrix4x4d{
+        Vector4d{xx + yy + zz, yz - zy, zx - xz, xy - yx},
+        Vector4d{yz - zy, xx - yy - zz, xy + yx, zx + xz},
+        Vector4d{zx - xz, xy + yx, -xx + yy - zz, yz + zy},
+        Vector4d{xy - yx, zx + xz, yz + zy, -xx - yy + zz}});
+    /* The eigenvector is (w, x, y, z) */
+    return Quaterniond{{q[1], q[2], q[3]}, q[0]}.normalized().toMatrix();
+}
+
+void kabschBatch(py::buffer input, py::buffer output, bool transpose) {
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer in{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    Py_buffer out{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    matrices(input, in, 3, "fd", "float or double", false);
+    Containers::ScopeGuard eIn{&in, PyBuffer_Release};
+    matrices(output, out, 3, "fd", "float or double", true);
+    Containers::ScopeGuard eOut{&out, PyBuffer_Release};
+
+    if(in.shape[0] != out.shape[0]) {
+        PyErr_Format(PyExc_ValueError, "expected %zi output matrices but got %zi", in.shape[0], out.shape[0]);
+        throw py::error_already_set{};
+    }
+
+    const bool inDouble = isDouble(in), outDouble = isDouble(out);
+    /* Each matrix is read completely before its result is written, so the
+       output can be the same buffer as the input */
+    pyThreadPool().parallelFor(std::size_t(in.shape[0]), 0, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i != end; ++i) {
+            Matrix3x3d h = inDouble ? readMatrix3x3<Double>(in, i) : readMatrix3x3<Float>(in, i);
+            if(transpose) h = h.transposed();
+            const Matrix3x3d rotation = kabsch(h);
+            if(outDouble) writeMatrix3x3<Double>(out, i, rotation);
+            else writeMatrix3x3<Float>(out, i, rotation);
+        }
+    });
+}
+
+/* Camera-relative transformations. Everything is calculated in doubles and
+   converted to floats only at the end, so objects far away from the origin
+   but close to the camera don't lose precision. The camera matrix is
+   row-major. */
+typedef void(*CameraRelativeKernel)(const Py_buffer&, const Py_buffer&, const Double(&)[16], std::size_t, std::size_t);
+
+template<class T> T& item(const Py_buffer& buffer, std::size_t i, std::size_t row, std::size_t col) {
+    return *reinterpret_cast<T*>(static_cast<char*>(buffer.buf) + i*buffer.strides[0] + row*buffer.strides[1] + col*buffer.strides[2]);
+}
+
+void scalarCameraRelativeKernel(const Py_buffer& in, const Py_buffer& out, const Double(&camera)[16], std::size_t begin, std::size_t end) {
+    for(std::size_t i = begin; i != end; ++i) {
+        Double transformation[16];
+        for(std::size_t row = 0; row != 4; ++row)
+            for(std::size_t col = 0; col != 4; ++col)
+                transformation[row*4 + col] = item<const Double>(in, i, row, col);
+
+        for(std::size_t row = 0; row != 4; ++row) {
+            for(std::size_t col = 0; col != 4; ++col) {
+                Double sum = 0.0;
+                for(std::size_t k = 0; k != 4; ++k)
+                    sum += camera[row*4 + k]*transformation[k*4 + col];
+                item<Float>(out, i, row, col) = Float(sum);
+            }
+        }
+    }
+}
+
+#ifdef MAGNUM_PY_VECTOR_KERNELS
+/* See math.functions.cpp for why this is ignored for the whole file */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef Double PyDouble4 __attribute__((vector_size(32)));
+
+/* Each row of the result is a linear combination of the transformation
+   rows, weighted by the camera matrix row */
+MAGNUM_PY_ALWAYS_INLINE void vectorCameraRelative(const Py_buffer& in, const Py_buffer& out, const Double(&camera)[16], std::size_t begin, std::size_t end) {
+    const bool contiguousRows = in.strides[2] == sizeof(Double);
+    for(std::size_t i = begin; i != end; ++i) {
+        PyDouble4 rows[4];
+        for(std::size_t row = 0; row != 4; ++row) {
+            if(contiguousRows) std::memcpy(rows + row, &item<const Double>(in, i, row, 0), sizeof(PyDouble4));
+            else for(std::size_t col = 0; col != 4; ++col)
+                rows[row][col] = item<const Double>(in, i, row, col);
+        }
+
+        for(std::size_t row = 0; row != 4; ++row) {
+            const PyDouble4 result = camera[row*4 + 0]*rows[0] +
+                                     camera[row*4 + 1]*rows[1] +
+                                     camera[row*4 + 2]*rows[2] +
+                                     camera[row*4 + 3]*rows[3];
+            for(std::size_t col = 0; col != 4; ++col)
+                item<Float>(out, i, row, col) = Float(result[col]);
+        }
+    }
+}
+
+/* SSE2 on x86, NEON on ARM, both being the baseline */
+void vectorCameraRelativeKernel(const Py_buffer& in, const Py_buffer& out, const Double(&camera)[16], std::size_t begin, std::size_t end) {
+    vectorCameraRelative(in, out, camera, begin, end);
+}
+
+#ifdef MAGNUM_PY_CPU_X86
+MAGNUM_PY_TARGET_AVX2 void avx2CameraRelativeKernel(const Py_buffer& in, const Py_buffer& out, const Double(&camera)[16], std::size_t begin, std::size_t end) {
+    vectorCameraRelative(in, out, camera, begin, end);
+}
+#endif
+#endif
+
+CameraRelativeKernel cameraRelativeKernel() {
+    #ifdef MAGNUM_PY_VECTOR_KERNELS
+    #ifdef MAGNUM_PY_CPU_X86
+    return pyCpuDispatch<CameraRelativeKernel>(scalarCameraRelativeKernel, vectorCameraRelativeKernel, avx2CameraRelativeKernel, nullptr, nullptr);
+    #else
+    return pyCpuDispatch<CameraRelativeKernel>(scalarCameraRelativeKernel, nullptr, nullptr, nullptr, vectorCameraRelativeKernel);
+    #endif
+    #else
+    return scalarCameraRelativeKernel;
+    #endif
+}
+
+}
+
+void mathAlgorithms(py::module& m) {
+    algorithms<Vector2>(m);
+    algorithms<Vector3>(m);
+    algorithms<Vector4>(m);
+    algorithms<Vector2d>(m);
+    algorithms<Vector3d>(m);
+    algorithms<Vector4d>(m);
+
+    m
+        .def("kabsch", [](py::buffer covariances, py::buffer out) {
+            kabschBatch(covariances, out, false);
+        }, "Optimal rotations for a batch of point set cross-covariances", py::arg("covariances"), py::arg("out"))
+        .def("orthonormalize", [](py::buffer matrices, py::buffer out) {
+            /* The rotation closest to m maximizes trace(r^T m), which is
+               what Kabsch does for a covariance of m^T */
+            kabschBatch(matrices, out, true);
+        }, "Closest rotations to a batch of matrices", py::arg("matrices"), py::arg("out"))
+        .def("camera_relative", [](py::buffer transformations, const Matrix4x4d& cameraMatrix, py::buffer out) {
+            static const CameraRelativeKernel kernel = cameraRelativeKernel();
+
+            /* GCC 4.8 otherwise loudly complains about missing initializers */
+            Py_buffer in{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+            Py_buffer output{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+            matrices(transformations, in, 4, "d", "double", false);
+            Containers::ScopeGuard eIn{&in, PyBuffer_Release};
+            matrices(out, output, 4, "f", "float", true);
+            Containers::ScopeGuard eOut{&output, PyBuffer_Release};
+
+            if(in.shape[0] != output.shape[0]) {
+                PyErr_Format(PyExc_ValueError, "expected %zi output matrices but got %zi", in.shape[0], output.shape[0]);
+                throw py::error_already_set{};
+            }
+
+            Double camera[16];
+            for(std::size_t row = 0; row != 4; ++row)
+                for(std::size_t col = 0; col != 4; ++col)
+                    camera[row*4 + col] = cameraMatrix[col][row];
+
+            pyThreadPool().parallelFor(std::size_t(in.shape[0]), 0, [&](std::size_t begin, std::size_t end) {
+                kernel(in, output, camera, begin, end);
+            });
+        }, "Camera-relative float transformations for a batch of double transformations", py::arg("transformations"), py::arg("camera_matrix"), py::arg("out"));
+}
+
+}
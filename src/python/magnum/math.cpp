@@ -458,6 +458,9 @@ void math(py::module& root, py::module& m) {
         .def("acos", [](Double angle) { return Math::acos(angle); }, "Arc cosine")
         .def("atan", [](Double angle) { return Math::atan(angle); }, "Arc tangent");
 
+    /* Array overloads of the above */
+    magnum::mathFunctions(root, m);
+
     /* These are needed for the quaternion, so register them before. Double
        versions are called from inside these. */
     magnum::mathVectorFloat(root, m);
@@ -478,6 +481,12 @@ void math(py::module& root, py::module& m) {
 
     /* Range */
     magnum::mathRange(root, m);
+
+    /* Algorithms, need the matrix and vector types */
+    magnum::mathAlgorithms(m);
+
+    /* Spatial hash */
+    magnum::mathSpatialHash(m);
 }
 
 }
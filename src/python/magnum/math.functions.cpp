@@ -0,0 +1,495 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Angle.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/cpu.h"
+#include "magnum/threadpool.h"
+
+namespace magnum {
+
+namespace {
+
+/* Array of angles in a given unit, the unit-safe counterpart to Deg / Rad
+   for array arguments. Only references the data, which is expected to be a
+   C-contiguous buffer of floats or doubles. */
+template<class T> struct PyAngleArray {
+    py::object data;
+};
+
+/* Scale to radians, applied to inputs of sin() and such and to outputs of
+   asin() and such */
+template<class> constexpr Double toRadians();
+template<> constexpr Double toRadians<Radd>() { return 1.0; }
+template<> constexpr Double toRadians<Degd>() { return Constantsd::pi()/180.0; }
+
+struct Sin {
+    template<class T> T operator()(T x) const { return std::sin(x); }
+};
+struct Cos {
+    template<class T> T operator()(T x) const { return std::cos(x); }
+};
+struct Tan {
+    template<class T> T operator()(T x) const { return std::tan(x); }
+};
+struct Asin {
+    template<class T> T operator()(T x) const { return std::asin(x); }
+};
+struct Acos {
+    template<class T> T operator()(T x) const { return std::acos(x); }
+};
+struct Atan {
+    template<class T> T operator()(T x) const { return std::atan(x); }
+};
+
+/* Computes out[i] = f(in[i]*inScale)*outScale */
+template<class T> using Kernel = void(*)(const T*, T*, std::size_t, T, T);
+template<class T> using SincosKernel = void(*)(const T*, T*, T*, std::size_t, T);
+
+template<class T, class F> void scalarKernel(const T* in, T* out, std::size_t count, T inScale, T outScale) {
+    for(std::size_t i = 0; i != count; ++i)
+        out[i] = F{}(in[i]*inScale)*outScale;
+}
+
+template<class T> void scalarSincosKernel(const T* in, T* sin, T* cos, std::size_t count, T scale) {
+    for(std::size_t i = 0; i != count; ++i) {
+        /* Input can be aliased with either of the outputs */
+        const T x = in[i]*scale;
+        sin[i] = std::sin(x);
+        cos[i] = std::cos(x);
+    }
+}
+
+#ifdef MAGNUM_PY_VECTOR_KERNELS
+/* The vector helpers below are always inlined into the kernels, which are
+   compiled for a particular instruction set, so the ABI of passing 32-byte
+   vectors to functions without AVX enabled doesn't matter. The warning is
+   reported at the end of the file where the templates get instantiated, so
+   it can't be just pushed and popped around. */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef float PyFloat4 __attribute__((vector_size(16)));
+typedef std::int32_t PyInt4 __attribute__((vector_size(16)));
+#ifdef MAGNUM_PY_CPU_X86
+typedef float PyFloat8 __attribute__((vector_size(32)));
+typedef std::int32_t PyInt8 __attribute__((vector_size(32)));
+#endif
+
+template<class> struct PyIntVector;
+template<> struct PyIntVector<PyFloat4> { typedef PyInt4 Type; };
+#ifdef MAGNUM_PY_CPU_X86
+template<> struct PyIntVector<PyFloat8> { typedef PyInt8 Type; };
+#endif
+
+/* Casts between vector types of the same size reinterpret the bits, which
+   is what all the helpers below rely on */
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V select(I mask, V a, V b) {
+    return (V)(((I)a & mask)|((I)b & ~mask));
+}
+
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE I signBit(V a) {
+    return (I)a & std::int32_t(0x80000000u);
+}
+
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V flipSign(V a, I sign) {
+    return (V)((I)a ^ sign);
+}
+
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V absolute(V a) {
+    return (V)((I)a & std::int32_t(0x7fffffff));
+}
+
+/* The vector extensions have no square root, so it's an estimate from the
+   exponent bits refined with three Newton iterations. Expects a
+   non-negative input. */
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V squareRoot(V a) {
+    V r = (V)(std::int32_t(0x5f375a86) - ((I)a >> 1));
+    r = r*(1.5f - 0.5f*a*r*r);
+    r = r*(1.5f - 0.5f*a*r*r);
+    r = r*(1.5f - 0.5f*a*r*r);
+    return a*r;
+}
+
+/* Range reduction and polynomials from Cephes sinf(), cosf(), tanf(),
+   asinf() and atanf(), with branches replaced by selects */
+
+/* Reduces a non-negative a to [-pi/4, pi/4] using a three-part pi/4. The
+   count of pi/2 steps is rounded with a magic constant, after which its low
+   bits can be taken directly from the mantissa. */
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V reduce(V a, I& quadrant) {
+    const V rounded = a*0.63661977236758134f + 12582912.0f;
+    quadrant = (I)rounded;
+    const V j = (rounded - 12582912.0f)*2.0f;
+    return ((a - j*0.78515625f) - j*2.4187564849853515625e-4f) - j*3.77489497744594108e-8f;
+}
+
+template<class V> MAGNUM_PY_ALWAYS_INLINE V sinPolynomial(V r, V z) {
+    return ((-1.9515295891e-4f*z + 8.3321608736e-3f)*z - 1.6666654611e-1f)*z*r + r;
+}
+
+template<class V> MAGNUM_PY_ALWAYS_INLINE V cosPolynomial(V z) {
+    return ((2.443315711809948e-5f*z - 1.388731625493765e-3f)*z + 4.166664568298827e-2f)*z*z - 0.5f*z + 1.0f;
+}
+
+/* asin(s) for s in [0, 0.5], z = s^2 */
+template<class V> MAGNUM_PY_ALWAYS_INLINE V asinPolynomial(V s, V z) {
+    return ((((4.2163199048e-2f*z + 2.4181311049e-2f)*z + 4.5470025998e-2f)*z + 7.4953002686e-2f)*z + 1.6666752422e-1f)*z*s + s;
+}
+
+template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE void vectorSincos(V x, V& sin, V& cos) {
+    I quadrant;
+    const V r = reduce(absolute(x), quadrant);
+    const V z = r*r;
+    const V s = sinPolynomial(r, z);
+    const V c = cosPolynomial(z);
+    const I odd = (quadrant & 1) == 1;
+    /* Multiplying moves the second bit to the sign bit without a signed
+       overflow */
+    sin = flipSign(select(odd, c, s), signBit(x) ^ ((quadrant & 2)*std::int32_t(-0x40000000)));
+    cos = flipSign(select(odd, s, c), ((quadrant + 1) & 2)*std::int32_t(-0x40000000));
+}
+
+struct VectorSin {
+    template<class V> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        V sin, cos;
+        vectorSincos(x, sin, cos);
+        return sin;
+    }
+};
+
+struct VectorCos {
+    template<class V> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        V sin, cos;
+        vectorSincos(x, sin, cos);
+        return cos;
+    }
+};
+
+struct VectorTan {
+    template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        I quadrant;
+        const V r = reduce(absolute(x), quadrant);
+        const V z = r*r;
+        const V t = (((((9.38540185543e-3f*z + 3.11992232697e-3f)*z + 2.44301354525e-2f)*z + 5.34112807005e-2f)*z + 1.33387994085e-1f)*z + 3.33331568548e-1f)*z*r + r;
+        return flipSign(select((quadrant & 1) == 1, -1.0f/t, t), signBit(x));
+    }
+};
+
+struct VectorAsin {
+    template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        const V a = absolute(x);
+        const I large = a > 0.5f;
+        /* Out-of-range inputs produce a NaN below, but clamp them here so
+           they don't slow down the square root */
+        const V z = select(large, absolute(0.5f*(1.0f - a)), a*a);
+        const V s = select(large, squareRoot(z), a);
+        const V p = asinPolynomial(s, z);
+        const V out = flipSign(select(large, 1.57079632679489662f - 2.0f*p, p), signBit(x));
+        return select(a > 1.0f, V{} + NAN, out);
+    }
+};
+
+struct VectorAcos {
+    template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        const V a = absolute(x);
+        const I large = a > 0.5f;
+        const V z = select(large, absolute(0.5f*(1.0f - a)), x*x);
+        const V s = select(large, squareRoot(z), x);
+        const V p = asinPolynomial(s, z);
+        const V out = select(large, select(x < 0.0f, 3.14159265358979324f - 2.0f*p, 2.0f*p), 1.57079632679489662f - p);
+        return select(a > 1.0f, V{} + NAN, out);
+    }
+};
+
+struct VectorAtan {
+    template<class V, class I = typename PyIntVector<V>::Type> MAGNUM_PY_ALWAYS_INLINE V operator()(V x) const {
+        const V a = absolute(x);
+        const I large = a > 2.414213562373095f;
+        const I medium = a > 0.4142135623730950f;
+        const V r = select(large, -1.0f/a, select(medium, (a - 1.0f)/(a + 1.0f), a));
+        const V offset = select(large, V{} + 1.57079632679489662f, select(medium, V{} + 0.78539816339744831f, V{}));
+        const V z = r*r;
+        return flipSign(offset + (((8.05374449538e-2f*z - 1.38776856032e-1f)*z + 1.99777106478e-1f)*z - 3.33329491539e-1f)*z*r + r, signBit(x));
+    }
+};
+
+template<class V> MAGNUM_PY_ALWAYS_INLINE V load(const Float* data) {
+    V out;
+    std::memcpy(&out, data, sizeof(V));
+    return out;
+}
+
+template<class V> MAGNUM_PY_ALWAYS_INLINE void store(Float* data, const V& value) {
+    std::memcpy(data, &value, sizeof(V));
+}
+
+/* The remaining items at the end go through a zero-padded vector, so all
+   items get the same approximation */
+template<class V, class F> MAGNUM_PY_ALWAYS_INLINE void vectorLoop(const Float* in, Float* out, std::size_t count, Float inScale, Float outScale) {
+    constexpr std::size_t Size = sizeof(V)/sizeof(Float);
+    std::size_t i = 0;
+    for(; i + Size <= count; i += Size)
+        store(out + i, F{}(load<V>(in + i)*inScale)*outScale);
+    if(i != count) {
+        Float padded[Size]{};
+        std::memcpy(padded, in + i, (count - i)*sizeof(Float));
+        store(padded, F{}(load<V>(padded)*inScale)*outScale);
+        std::memcpy(out + i, padded, (count - i)*sizeof(Float));
+    }
+}
+
+template<class V> MAGNUM_PY_ALWAYS_INLINE void vectorSincosLoop(const Float* in, Float* sin, Float* cos, std::size_t count, Float scale) {
+    constexpr std::size_t Size = sizeof(V)/sizeof(Float);
+    std::size_t i = 0;
+    V s, c;
+    for(; i + Size <= count; i += Size) {
+        vectorSincos(load<V>(in + i)*scale, s, c);
+        store(sin + i, s);
+        store(cos + i, c);
+    }
+    if(i != count) {
+        Float padded[Size]{};
+        std::memcpy(padded, in + i, (count - i)*sizeof(Float));
+        vectorSincos(load<V>(padded)*scale, s, c);
+        store(padded, s);
+        std::memcpy(sin + i, padded, (count - i)*sizeof(Float));
+        store(padded, c);
+        std::memcpy(cos + i, padded, (count - i)*sizeof(Float));
+    }
+}
+
+/* SSE2 on x86, NEON on ARM, both being the baseline */
+template<class F> void vector4Kernel(const Float* in, Float* out, std::size_t count, Float inScale, Float outScale) {
+    vectorLoop<PyFloat4, F>(in, out, count, inScale, outScale);
+}
+
+void vector4SincosKernel(const Float* in, Float* sin, Float* cos, std::size_t count, Float scale) {
+    vectorSincosLoop<PyFloat4>(in, sin, cos, count, scale);
+}
+
+#ifdef MAGNUM_PY_CPU_X86
+template<class F> MAGNUM_PY_TARGET_AVX2 void avx2Kernel(const Float* in, Float* out, std::size_t count, Float inScale, Float outScale) {
+    vectorLoop<PyFloat8, F>(in, out, count, inScale, outScale);
+}
+
+MAGNUM_PY_TARGET_AVX2 void avx2SincosKernel(const Float* in, Float* sin, Float* cos, std::size_t count, Float scale) {
+    vectorSincosLoop<PyFloat8>(in, sin, cos, count, scale);
+}
+#endif
+
+#else
+/* Never called, only to have the same dispatch code in all cases */
+typedef Sin VectorSin;
+typedef Cos VectorCos;
+typedef Tan VectorTan;
+typedef Asin VectorAsin;
+typedef Acos VectorAcos;
+typedef Atan VectorAtan;
+#endif
+
+/* Doubles always go through the C library, floats through the best vector
+   kernel available */
+template<class F, class VectorF> Kernel<Float> floatKernel() {
+    #ifdef MAGNUM_PY_VECTOR_KERNELS
+    #ifdef MAGNUM_PY_CPU_X86
+    return pyCpuDispatch<Kernel<Float>>(scalarKernel<Float, F>, vector4Kernel<VectorF>, avx2Kernel<VectorF>, nullptr, nullptr);
+    #else
+    return pyCpuDispatch<Kernel<Float>>(scalarKernel<Float, F>, nullptr, nullptr, nullptr, vector4Kernel<VectorF>);
+    #endif
+    #else
+    return scalarKernel<Float, F>;
+    #endif
+}
+
+SincosKernel<Float> floatSincosKernel() {
+    #ifdef MAGNUM_PY_VECTOR_KERNELS
+    #ifdef MAGNUM_PY_CPU_X86
+    return pyCpuDispatch<SincosKernel<Float>>(scalarSincosKernel<Float>, vector4SincosKernel, avx2SincosKernel, nullptr, nullptr);
+    #else
+    return pyCpuDispatch<SincosKernel<Float>>(scalarSincosKernel<Float>, nullptr, nullptr, nullptr, vector4SincosKernel);
+    #endif
+    #else
+    return scalarSincosKernel<Float>;
+    #endif
+}
+
+/* A C-contiguous buffer of floats or doubles */
+struct PyFloatBuffer {
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    bool isDouble;
+
+    std::size_t size() const {
+        return std::size_t(buffer.len/buffer.itemsize);
+    }
+};
+
+void acquire(py::handle object, PyFloatBuffer& out, bool writable) {
+    if(PyObject_GetBuffer(object.ptr(), &out.buffer, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT|(writable ? PyBUF_WRITABLE : 0)) != 0)
+        throw py::error_already_set{};
+
+    /* Native byte order only */
+    const char* format = out.buffer.format ? out.buffer.format : "B";
+    if(*format == '@' || *format == '=') ++format;
+    if((*format != 'f' && *format != 'd') || format[1]) {
+        PyErr_Format(PyExc_BufferError, "expected a float or double format but got %s", out.buffer.format);
+        PyBuffer_Release(&out.buffer);
+        throw py::error_already_set{};
+    }
+    out.isDouble = *format == 'd';
+}
+
+void checkOutput(const PyFloatBuffer& in, const PyFloatBuffer& out) {
+    if(in.isDouble != out.isDouble) {
+        PyErr_Format(PyExc_BufferError, "expected an output format of %s but got %s", in.buffer.format, out.buffer.format);
+        throw py::error_already_set{};
+    }
+    if(in.size() != out.size()) {
+        PyErr_Format(PyExc_ValueError, "expected %zu output items but got %zu", in.size(), out.size());
+        throw py::error_already_set{};
+    }
+}
+
+/* Applies the kernel in parallel. The output is either the same buffer as
+   the input or one not overlapping it. */
+template<class F, class VectorF> void apply(py::handle input, py::handle output, Double inScale, Double outScale) {
+    static const Kernel<Float> kernel = floatKernel<F, VectorF>();
+
+    PyFloatBuffer in, out;
+    acquire(input, in, false);
+    Containers::ScopeGuard eIn{&in.buffer, PyBuffer_Release};
+    acquire(output, out, true);
+    Containers::ScopeGuard eOut{&out.buffer, PyBuffer_Release};
+    checkOutput(in, out);
+
+    if(in.isDouble) {
+        const Double* const inData = static_cast<const Double*>(in.buffer.buf);
+        Double* const outData = static_cast<Double*>(out.buffer.buf);
+        pyThreadPool().parallelFor(in.size(), 0, [&](std::size_t begin, std::size_t end) {
+            scalarKernel<Double, F>(inData + begin, outData + begin, end - begin, inScale, outScale);
+        });
+    } else {
+        const Float* const inData = static_cast<const Float*>(in.buffer.buf);
+        Float* const outData = static_cast<Float*>(out.buffer.buf);
+        pyThreadPool().parallelFor(in.size(), 0, [&](std::size_t begin, std::size_t end) {
+            kernel(inData + begin, outData + begin, end - begin, Float(inScale), Float(outScale));
+        });
+    }
+}
+
+void applySincos(py::handle input, py::handle sinOutput, py::handle cosOutput, Double scale) {
+    static const SincosKernel<Float> kernel = floatSincosKernel();
+
+    PyFloatBuffer in, sin, cos;
+    acquire(input, in, false);
+    Containers::ScopeGuard eIn{&in.buffer, PyBuffer_Release};
+    acquire(sinOutput, sin, true);
+    Containers::ScopeGuard eSin{&sin.buffer, PyBuffer_Release};
+    acquire(cosOutput, cos, true);
+    Containers::ScopeGuard eCos{&cos.buffer, PyBuffer_Release};
+    checkOutput(in, sin);
+    checkOutput(in, cos);
+
+    if(in.isDouble) {
+        const Double* const inData = static_cast<const Double*>(in.buffer.buf);
+        Double* const sinData = static_cast<Double*>(sin.buffer.buf);
+        Double* const cosData = static_cast<Double*>(cos.buffer.buf);
+        pyThreadPool().parallelFor(in.size(), 0, [&](std::size_t begin, std::size_t end) {
+            scalarSincosKernel<Double>(inData + begin, sinData + begin, cosData + begin, end - begin, scale);
+        });
+    } else {
+        const Float* const inData = static_cast<const Float*>(in.buffer.buf);
+        Float* const sinData = static_cast<Float*>(sin.buffer.buf);
+        Float* const cosData = static_cast<Float*>(cos.buffer.buf);
+        pyThreadPool().parallelFor(in.size(), 0, [&](std::size_t begin, std::size_t end) {
+            kernel(inData + begin, sinData + begin, cosData + begin, end - begin, Float(scale));
+        });
+    }
+}
+
+template<class T> void angleArray(py::class_<PyAngleArray<T>>& c) {
+    c
+        .def(py::init([](py::buffer data) {
+            /* Check the format upfront so errors don't surface only when
+               the array is used */
+            PyFloatBuffer buffer;
+            acquire(data, buffer, false);
+            PyBuffer_Release(&buffer.buffer);
+            return PyAngleArray<T>{std::move(data)};
+        }), "Constructor", py::arg("data"))
+        .def_property_readonly("data", [](const PyAngleArray<T>& self) {
+            return self.data;
+        }, "Underlying data");
+}
+
+template<class T> void arrayFunctions(py::module& m) {
+    m
+        .def("sin", [](const PyAngleArray<T>& angles, py::object out) {
+            apply<Sin, VectorSin>(angles.data, out.is_none() ? angles.data : out, toRadians<T>(), 1.0);
+        }, "Sine of an array", py::arg("angles"), py::arg("out") = py::none{})
+        .def("cos", [](const PyAngleArray<T>& angles, py::object out) {
+            apply<Cos, VectorCos>(angles.data, out.is_none() ? angles.data : out, toRadians<T>(), 1.0);
+        }, "Cosine of an array", py::arg("angles"), py::arg("out") = py::none{})
+        .def("sincos", [](const PyAngleArray<T>& angles, py::buffer sin, py::buffer cos) {
+            applySincos(angles.data, sin, cos, toRadians<T>());
+        }, "Sine and cosine of an array", py::arg("angles"), py::arg("sin"), py::arg("cos"))
+        .def("tan", [](const PyAngleArray<T>& angles, py::object out) {
+            apply<Tan, VectorTan>(angles.data, out.is_none() ? angles.data : out, toRadians<T>(), 1.0);
+        }, "Tangent of an array", py::arg("angles"), py::arg("out") = py::none{})
+        .def("asin", [](py::buffer values, const PyAngleArray<T>& out) {
+            apply<Asin, VectorAsin>(values, out.data, 1.0, 1.0/toRadians<T>());
+        }, "Arc sine of an array", py::arg("values"), py::arg("out"))
+        .def("acos", [](py::buffer values, const PyAngleArray<T>& out) {
+            apply<Acos, VectorAcos>(values, out.data, 1.0, 1.0/toRadians<T>());
+        }, "Arc cosine of an array", py::arg("values"), py::arg("out"))
+        .def("atan", [](py::buffer values, const PyAngleArray<T>& out) {
+            apply<Atan, VectorAtan>(values, out.data, 1.0, 1.0/toRadians<T>());
+        }, "Arc tangent of an array", py::arg("values"), py::arg("out"));
+}
+
+}
+
+void mathFunctions(py::module& root, py::module& m) {
+    py::class_<PyAngleArray<Degd>> degArray{root, "DegArray", "Array of degrees"};
+    py::class_<PyAngleArray<Radd>> radArray{root, "RadArray", "Array of radians"};
+    angleArray(degArray);
+    angleArray(radArray);
+
+    /* Overloads of the scalar functions defined in math() */
+    arrayFunctions<Radd>(m);
+    arrayFunctions<Degd>(m);
+}
+
+}
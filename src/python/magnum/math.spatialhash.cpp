@@ -0,0 +1,412 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "magnum/bootstrap.h"
+#include "magnum/threadpool.h"
+
+namespace magnum {
+
+namespace {
+
+/* Uniform grid over an unbounded space. Cells are hashed into a table twice
+   the size of the point count and each table entry is a singly-linked list
+   of points, threaded through the next array. Lists are filled with an
+   atomic exchange, so construction runs in parallel, and a single point can
+   be moved to another list cheaply, which is what update() relies on.
+
+   Different cells can end up in the same list, so points are always checked
+   against the cell being visited. Queries release the GIL and update()
+   refuses to run while any of them is in progress. */
+struct PySpatialHash {
+    enum: UnsignedInt { Empty = ~UnsignedInt{} };
+
+    explicit PySpatialHash(Containers::Array<Vector3>&& points, Float cellSize);
+
+    Vector3i cellFor(const Vector3& point) const {
+        return Vector3i{Math::floor(point*inverseCellSize)};
+    }
+
+    std::size_t bucketFor(const Vector3i& cell) const {
+        return ((UnsignedInt(cell.x())*73856093u)^
+                (UnsignedInt(cell.y())*19349663u)^
+                (UnsignedInt(cell.z())*83492791u)) & mask;
+    }
+
+    void extendBounds(const Vector3i& cell) {
+        bounds = Range3Di{Math::min(bounds.min(), cell), Math::max(bounds.max(), cell)};
+    }
+
+    void update(Containers::ArrayView<const UnsignedInt> indices, Containers::ArrayView<const Vector3> positions);
+
+    void queryRadius(const Vector3& point, Float radius, std::vector<UnsignedInt>& out) const;
+    void queryNearest(const Vector3& point, std::size_t count, Float maxDistance, std::vector<std::pair<Float, UnsignedInt>>& heap, std::vector<UnsignedInt>& out) const;
+
+    Float cellSize, inverseCellSize;
+    std::size_t mask;
+    Containers::Array<Vector3> points;
+    Containers::Array<Vector3i> cells;
+    Containers::Array<UnsignedInt> next;
+    Containers::Array<std::atomic<UnsignedInt>> heads;
+    /* Cells containing at least one point, or a superset of them after
+       update(). Empty if there are no points. */
+    Range3Di bounds{Vector3i{std::numeric_limits<Int>::max()}, Vector3i{std::numeric_limits<Int>::min()}};
+    std::atomic<std::size_t> activeQueries{};
+};
+
+PySpatialHash::PySpatialHash(Containers::Array<Vector3>&& points_, Float cellSize): cellSize{cellSize}, inverseCellSize{1.0f/cellSize}, points{std::move(points_)}, cells{Containers::NoInit, points.size()}, next{Containers::NoInit, points.size()} {
+    std::size_t size = 1;
+    while(size < points.size()*2) size *= 2;
+    mask = size - 1;
+    heads = Containers::Array<std::atomic<UnsignedInt>>{size};
+    for(std::atomic<UnsignedInt>& head: heads) head.store(Empty, std::memory_order_relaxed);
+
+    std::mutex boundsMutex;
+    pyThreadPool().parallelFor(points.size(), 0, [&](std::size_t begin, std::size_t end) {
+        Range3Di chunkBounds = bounds;
+        for(std::size_t i = begin; i != end; ++i) {
+            const Vector3i cell = cells[i] = cellFor(points[i]);
+            next[i] = heads[bucketFor(cell)].exchange(UnsignedInt(i), std::memory_order_relaxed);
+            chunkBounds = Range3Di{Math::min(chunkBounds.min(), cell), Math::max(chunkBounds.max(), cell)};
+        }
+
+        std::lock_guard<std::mutex> lock{boundsMutex};
+        extendBounds(chunkBounds.min());
+        extendBounds(chunkBounds.max());
+    });
+}
+
+void PySpatialHash::update(Containers::ArrayView<const UnsignedInt> indices, Containers::ArrayView<const Vector3> positions) {
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        const UnsignedInt index = indices[i];
+        points[index] = positions[i];
+        const Vector3i cell = cellFor(positions[i]);
+        if(cell == cells[index]) continue;
+
+        const std::size_t from = bucketFor(cells[index]), to = bucketFor(cell);
+        cells[index] = cell;
+        extendBounds(cell);
+        if(from == to) continue;
+
+        /* Unlink from the old list, which is a few items on average */
+        std::atomic<UnsignedInt>& head = heads[from];
+        if(head.load(std::memory_order_relaxed) == index)
+            head.store(next[index], std::memory_order_relaxed);
+        else {
+            UnsignedInt j = head.load(std::memory_order_relaxed);
+            while(next[j] != index) j = next[j];
+            next[j] = next[index];
+        }
+
+        next[index] = heads[to].exchange(index, std::memory_order_relaxed);
+    }
+}
+
+void PySpatialHash::queryRadius(const Vector3& point, const Float radius, std::vector<UnsignedInt>& out) const {
+    const std::size_t begin = out.size();
+    const Vector3i min = Math::max(cellFor(point - Vector3{radius}), bounds.min());
+    const Vector3i max = Math::min(cellFor(point + Vector3{radius}), bounds.max());
+    const Float radiusSquared = radius*radius;
+    for(Int z = min.z(); z <= max.z(); ++z) {
+        for(Int y = min.y(); y <= max.y(); ++y) {
+            for(Int x = min.x(); x <= max.x(); ++x) {
+                const Vector3i cell{x, y, z};
+                for(UnsignedInt i = heads[bucketFor(cell)].load(std::memory_order_relaxed); i != Empty; i = next[i])
+                    if(cells[i] == cell && (points[i] - point).dot() <= radiusSquared)
+                        out.push_back(i);
+            }
+        }
+    }
+
+    /* List order depends on thread timing during construction, sort to have
+       deterministic output */
+    std::sort(out.begin() + begin, out.end());
+}
+
+void PySpatialHash::queryNearest(const Vector3& point, const std::size_t count, const Float maxDistance, std::vector<std::pair<Float, UnsignedInt>>& heap, std::vector<UnsignedInt>& out) const {
+    if(!count || points.empty()) return;
+
+    /* Max-heap of the closest points found so far, ties broken by index */
+    heap.clear();
+    const Float maxDistanceSquared = maxDistance*maxDistance;
+    auto visit = [&](const Vector3i& cell) {
+        for(UnsignedInt i = heads[bucketFor(cell)].load(std::memory_order_relaxed); i != Empty; i = next[i]) {
+            if(cells[i] != cell) continue;
+            const std::pair<Float, UnsignedInt> candidate{(points[i] - point).dot(), i};
+            if(candidate.first > maxDistanceSquared) continue;
+            if(heap.size() < count) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if(candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+
+    /* Visit shells of cells around the one containing the point, starting
+       with the first one that overlaps the bounds. Cells in the shell after
+       ring d are at least d cells away, so once the heap is full and its
+       farthest point is closer than that, nothing closer can be found. */
+    const Vector3i center = cellFor(point);
+    const Vector3i outside = Math::max(Math::max(bounds.min() - center, center - bounds.max()), Vector3i{0});
+    for(Int d = outside.max(); ; ++d) {
+        const Vector3i min = Math::max(center - Vector3i{d}, bounds.min());
+        const Vector3i max = Math::min(center + Vector3i{d}, bounds.max());
+        for(Int z = min.z(); z <= max.z(); ++z) {
+            for(Int y = min.y(); y <= max.y(); ++y) {
+                /* On the faces visit the whole row, inside only the two
+                   cells on the shell */
+                if(std::abs(z - center.z()) == d || std::abs(y - center.y()) == d) {
+                    for(Int x = min.x(); x <= max.x(); ++x)
+                        visit({x, y, z});
+                } else {
+                    if(center.x() - d >= min.x()) visit({center.x() - d, y, z});
+                    if(center.x() + d <= max.x()) visit({center.x() + d, y, z});
+                }
+            }
+        }
+
+        const Float reached = Float(d)*cellSize;
+        if(heap.size() == count && heap.front().first <= reached*reached) break;
+        if(reached > maxDistance) break;
+        if((center - Vector3i{d} <= bounds.min()).all() && (center + Vector3i{d} >= bounds.max()).all()) break;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for(const std::pair<Float, UnsignedInt>& i: heap) out.push_back(i.second);
+}
+
+/* Points in a buffer of shape (n, 3), floats or doubles */
+Containers::Array<Vector3> readPoints(py::buffer points) {
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    if(PyObject_GetBuffer(points.ptr(), &buffer, PyBUF_STRIDES|PyBUF_FORMAT) != 0)
+        throw py::error_already_set{};
+
+    Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+
+    if(buffer.ndim != 2) {
+        PyErr_Format(PyExc_BufferError, "expected 2 dimensions but got %i", buffer.ndim);
+        throw py::error_already_set{};
+    }
+    if(buffer.shape[1] != 3) {
+        PyErr_Format(PyExc_BufferError, "expected a shape of (n, 3) but got (%zi, %zi)", buffer.shape[0], buffer.shape[1]);
+        throw py::error_already_set{};
+    }
+
+    /* Native byte order only */
+    const char* format = buffer.format ? buffer.format : "B";
+    if(*format == '@' || *format == '=') ++format;
+    if((*format != 'f' && *format != 'd') || format[1]) {
+        PyErr_Format(PyExc_BufferError, "expected a float or double format but got %s", buffer.format);
+        throw py::error_already_set{};
+    }
+
+    Containers::Array<Vector3> out{Containers::NoInit, std::size_t(buffer.shape[0])};
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        const char* const item = static_cast<const char*>(buffer.buf) + i*buffer.strides[0];
+        for(std::size_t j = 0; j != 3; ++j) {
+            const char* const component = item + j*buffer.strides[1];
+            out[i][j] = *format == 'd' ?
+                Float(*reinterpret_cast<const Double*>(component)) :
+                *reinterpret_cast<const Float*>(component);
+        }
+    }
+    return out;
+}
+
+template<class T> void readIndices(const Py_buffer& buffer, std::size_t bound, Containers::ArrayView<UnsignedInt> out) {
+    for(std::size_t i = 0; i != out.size(); ++i) {
+        const T index = *reinterpret_cast<const T*>(static_cast<const char*>(buffer.buf) + i*buffer.strides[0]);
+        /* Negative values wrap around and fail the check as well */
+        if(static_cast<unsigned long long>(index) >= bound) {
+            PyErr_Format(PyExc_IndexError, "index %lld out of range for %zu points", static_cast<long long>(index), bound);
+            throw py::error_already_set{};
+        }
+        out[i] = UnsignedInt(index);
+    }
+}
+
+Containers::Array<UnsignedInt> readIndices(py::buffer indices, const std::size_t bound) {
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    if(PyObject_GetBuffer(indices.ptr(), &buffer, PyBUF_STRIDES|PyBUF_FORMAT) != 0)
+        throw py::error_already_set{};
+
+    Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+
+    if(buffer.ndim != 1) {
+        PyErr_Format(PyExc_BufferError, "expected 1 dimension but got %i", buffer.ndim);
+        throw py::error_already_set{};
+    }
+
+    /* Native byte order only */
+    const char* format = buffer.format ? buffer.format : "B";
+    if(*format == '@' || *format == '=') ++format;
+
+    Containers::Array<UnsignedInt> out{Containers::NoInit, std::size_t(buffer.shape[0])};
+    if(std::strlen(format) != 1) format = "";
+    switch(*format) {
+        case 'b': readIndices<signed char>(buffer, bound, out); break;
+        case 'B': readIndices<unsigned char>(buffer, bound, out); break;
+        case 'h': readIndices<short>(buffer, bound, out); break;
+        case 'H': readIndices<unsigned short>(buffer, bound, out); break;
+        case 'i': readIndices<int>(buffer, bound, out); break;
+        case 'I': readIndices<unsigned int>(buffer, bound, out); break;
+        case 'l': readIndices<long>(buffer, bound, out); break;
+        case 'L': readIndices<unsigned long>(buffer, bound, out); break;
+        case 'q': readIndices<long long>(buffer, bound, out); break;
+        case 'Q': readIndices<unsigned long long>(buffer, bound, out); break;
+        case 'n': readIndices<Py_ssize_t>(buffer, bound, out); break;
+        case 'N': readIndices<std::size_t>(buffer, bound, out); break;
+        default:
+            PyErr_Format(PyExc_BufferError, "expected an integer index type but got %s", buffer.format);
+            throw py::error_already_set{};
+    }
+
+    return out;
+}
+
+/* A memoryview of unsigned ints owning its memory */
+py::object indexView(std::size_t size, UnsignedInt*& data) {
+    py::object bytes = py::reinterpret_steal<py::object>(PyByteArray_FromStringAndSize(nullptr, Py_ssize_t(size*sizeof(UnsignedInt))));
+    if(!bytes) throw py::error_already_set{};
+    data = reinterpret_cast<UnsignedInt*>(PyByteArray_AS_STRING(bytes.ptr()));
+    py::object view = py::reinterpret_steal<py::object>(PyMemoryView_FromObject(bytes.ptr()));
+    if(!view) throw py::error_already_set{};
+    return view.attr("cast")("I");
+}
+
+struct ActiveQuery {
+    explicit ActiveQuery(std::atomic<std::size_t>& count): count(count) { ++count; }
+    ~ActiveQuery() { --count; }
+
+    std::atomic<std::size_t>& count;
+};
+
+/* Runs the query for each point in parallel and returns the results as a
+   (offsets, indices) tuple, where results for point i are
+   indices[offsets[i]:offsets[i + 1]]. Points are processed in fixed-size
+   chunks that each collect their results separately, which are then
+   concatenated in order. */
+template<class Query> py::tuple csrQuery(PySpatialHash& self, Containers::ArrayView<const Vector3> points, const Query& query) {
+    constexpr std::size_t ChunkSize = 256;
+    const std::size_t chunkCount = (points.size() + ChunkSize - 1)/ChunkSize;
+    Containers::Array<std::vector<UnsignedInt>> results{chunkCount};
+    Containers::Array<UnsignedInt> counts{Containers::NoInit, points.size()};
+
+    ActiveQuery active{self.activeQueries};
+    pyThreadPool().parallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t chunk = begin; chunk != end; ++chunk) {
+            std::vector<UnsignedInt>& out = results[chunk];
+            for(std::size_t i = chunk*ChunkSize, iEnd = Math::min(i + ChunkSize, points.size()); i != iEnd; ++i) {
+                const std::size_t before = out.size();
+                query(points[i], out);
+                counts[i] = UnsignedInt(out.size() - before);
+            }
+        }
+    });
+
+    UnsignedInt* offsets;
+    py::object offsetView = indexView(points.size() + 1, offsets);
+    offsets[0] = 0;
+    for(std::size_t i = 0; i != points.size(); ++i)
+        offsets[i + 1] = offsets[i] + counts[i];
+
+    UnsignedInt* indices;
+    py::object indexData = indexView(offsets[points.size()], indices);
+    for(const std::vector<UnsignedInt>& chunk: results) {
+        std::copy(chunk.begin(), chunk.end(), indices);
+        indices += chunk.size();
+    }
+
+    return py::make_tuple(offsetView, indexData);
+}
+
+}
+
+void mathSpatialHash(py::module& m) {
+    py::class_<PySpatialHash>{m, "SpatialHash", "Uniform grid spatial hash"}
+        .def(py::init([](py::buffer points, Float cellSize) {
+            if(!(cellSize > 0.0f)) {
+                PyErr_SetString(PyExc_ValueError, "cell size has to be positive");
+                throw py::error_already_set{};
+            }
+            return new PySpatialHash{readPoints(points), cellSize};
+        }), "Constructor", py::arg("points"), py::arg("cell_size"))
+        .def_property_readonly("cell_size", [](const PySpatialHash& self) {
+            return self.cellSize;
+        }, "Cell size")
+        .def("__len__", [](const PySpatialHash& self) {
+            return self.points.size();
+        }, "Point count")
+        .def("update", [](PySpatialHash& self, py::buffer indices, py::buffer points) {
+            if(self.activeQueries) {
+                PyErr_SetString(PyExc_RuntimeError, "can't update while a query is running");
+                throw py::error_already_set{};
+            }
+            const Containers::Array<UnsignedInt> i = readIndices(indices, self.points.size());
+            const Containers::Array<Vector3> p = readPoints(points);
+            if(i.size() != p.size()) {
+                PyErr_Format(PyExc_ValueError, "expected %zu points but got %zu", i.size(), p.size());
+                throw py::error_already_set{};
+            }
+
+            /* The GIL stays held so no query can start in the meantime */
+            self.update(i, p);
+        }, "Move points to new positions", py::arg("indices"), py::arg("points"))
+        .def("query_radius", [](PySpatialHash& self, py::buffer points, Float radius) {
+            const Containers::Array<Vector3> p = readPoints(points);
+            return csrQuery(self, p, [&self, radius](const Vector3& point, std::vector<UnsignedInt>& out) {
+                self.queryRadius(point, radius, out);
+            });
+        }, "Points within a radius", py::arg("points"), py::arg("radius"))
+        .def("query_nearest", [](PySpatialHash& self, py::buffer points, std::size_t count, Float maxDistance) {
+            const Containers::Array<Vector3> p = readPoints(points);
+            return csrQuery(self, p, [&self, count, maxDistance](const Vector3& point, std::vector<UnsignedInt>& out) {
+                thread_local std::vector<std::pair<Float, UnsignedInt>> heap;
+                self.queryNearest(point, count, maxDistance, heap, out);
+            });
+        }, "Nearest points", py::arg("points"), py::arg("count"), py::arg("max_distance") = Constants::inf());
+}
+
+}
@@ -30,6 +30,7 @@
 
 #include "corrade/EnumOperators.h"
 #include "magnum/bootstrap.h"
+#include "magnum/tracing.h"
 
 namespace magnum {
 
@@ -52,6 +53,7 @@ void meshtools(py::module& m) {
 
     m
         .def("compile", [](const Trade::MeshData& meshData, MeshTools::CompileFlag flags) {
+            PyTraceZone zone{"meshtools", "compile"};
             return MeshTools::compile(meshData, flags);
         }, "Compile 3D mesh data", py::arg("mesh_data"), py::arg("flags") = MeshTools::CompileFlag{});
 }
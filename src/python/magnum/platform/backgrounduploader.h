@@ -0,0 +1,302 @@
+#ifndef magnum_platform_backgrounduploader_h
+#define magnum_platform_backgrounduploader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Platform/GLContext.h>
+
+#ifdef MAGNUM_BUILD_STATIC
+#include "magnum/staticconfigure.h"
+#endif
+
+#ifdef Magnum_MeshTools_FOUND
+#include <Magnum/MeshTools/Compile.h>
+#include <Magnum/Trade/MeshData.h>
+#endif
+
+#include "magnum/bootstrap.h"
+
+/* A second context is useful only if the GL::Context is thread-local, and
+   fence syncs are not in ES2 */
+#if defined(MAGNUM_BUILD_MULTITHREADED) && !defined(MAGNUM_TARGET_GLES2)
+#define MAGNUM_PYTHON_BACKGROUND_UPLOADER
+#endif
+
+namespace magnum { namespace platform {
+
+#ifdef MAGNUM_PYTHON_BACKGROUND_UPLOADER
+/* Uploads textures and mesh buffers on a worker thread that owns a context
+   shared with the one that was current when the uploader got created. The
+   worker doesn't touch anything Python, the Python-side objects are kept in
+   a separate map that's accessed only from the main thread. Mesh buffers are
+   shared between contexts but vertex array objects aren't, so the final
+   GL::Mesh is assembled on the main thread in poll(). */
+template<class Context, class ContextHandle> class PyBackgroundUploader {
+    public:
+        explicit PyBackgroundUploader(ContextHandle sharedContext) {
+            _thread = std::thread{&PyBackgroundUploader::run, this, sharedContext};
+
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this]{ return _state != State::Starting; });
+            if(_state == State::Failed) {
+                lock.unlock();
+                _thread.join();
+                PyErr_SetString(PyExc_RuntimeError, "cannot create a shared context");
+                throw py::error_already_set{};
+            }
+        }
+
+        ~PyBackgroundUploader() {
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _state = State::Stopping;
+            }
+            _condition.notify_all();
+            if(_thread.joinable()) _thread.join();
+        }
+
+        std::size_t pendingCount() const { return _futures.size(); }
+
+        py::object uploadTexture(py::object image, GL::TextureFormat internalFormat, bool generateMipmap) {
+            Job job;
+            job.image = py::cast<ImageView2D>(image);
+            job.internalFormat = internalFormat;
+            job.generateMipmap = generateMipmap;
+            return submit(std::move(job), std::move(image));
+        }
+
+        #ifdef Magnum_MeshTools_FOUND
+        py::object uploadMesh(py::object meshData) {
+            Job job;
+            job.meshData = &py::cast<const Trade::MeshData&>(meshData);
+            return submit(std::move(job), std::move(meshData));
+        }
+        #endif
+
+        /* Resolves futures of all finished jobs, returns their count */
+        std::size_t poll() {
+            std::vector<Job> done;
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                done.swap(_done);
+            }
+
+            for(Job& job: done) {
+                auto found = _futures.find(job.id);
+                CORRADE_INTERNAL_ASSERT(found != _futures.end());
+                py::object future = std::move(found->second.future);
+                _futures.erase(found);
+
+                if(job.texture) {
+                    future.attr("set_result")(py::cast(std::move(*job.texture)));
+                    continue;
+                }
+
+                #ifdef Magnum_MeshTools_FOUND
+                future.attr("set_result")(py::cast(MeshTools::compile(*job.meshData, std::move(job.indices), std::move(job.vertices))));
+                #endif
+            }
+
+            return done.size();
+        }
+
+        /* Waits until all submitted jobs are finished and resolves them */
+        void finish() {
+            {
+                py::gil_scoped_release release;
+                std::unique_lock<std::mutex> lock{_mutex};
+                _condition.wait(lock, [this]{ return _queue.empty() && !_busy; });
+            }
+            poll();
+        }
+
+    private:
+        enum class State { Starting, Running, Failed, Stopping };
+
+        struct Job {
+            std::size_t id;
+            ImageView2D image{PixelFormat::RGBA8Unorm, Vector2i{}};
+            GL::TextureFormat internalFormat;
+            bool generateMipmap;
+            Containers::Optional<GL::Texture2D> texture;
+            #ifdef Magnum_MeshTools_FOUND
+            const Trade::MeshData* meshData{};
+            #endif
+            GL::Buffer indices{NoCreate};
+            GL::Buffer vertices{NoCreate};
+        };
+
+        struct PendingJob {
+            py::object future;
+            /* Keeps the source data alive until the upload is done */
+            py::object source;
+        };
+
+        py::object submit(Job&& job, py::object source) {
+            job.id = _nextId++;
+            py::object future = py::module::import("concurrent.futures").attr("Future")();
+            _futures.emplace(job.id, PendingJob{future, std::move(source)});
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _queue.push_back(std::move(job));
+            }
+            _condition.notify_all();
+            return future;
+        }
+
+        void run(ContextHandle sharedContext) {
+            Context context{typename Context::Configuration{}.setSharedContext(sharedContext)};
+            if(!context.isCreated() || !context.makeCurrent()) {
+                {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                    _state = State::Failed;
+                }
+                _condition.notify_all();
+                return;
+            }
+
+            /* Thanks to MAGNUM_BUILD_MULTITHREADED this is current only in
+               this thread and doesn't affect the main one */
+            Platform::GLContext glContext;
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _state = State::Running;
+            }
+            _condition.notify_all();
+
+            for(;;) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock{_mutex};
+                    _condition.wait(lock, [this]{ return _state == State::Stopping || !_queue.empty(); });
+                    if(_state == State::Stopping) return;
+                    job = std::move(_queue.front());
+                    _queue.pop_front();
+                    _busy = true;
+                }
+
+                upload(job);
+
+                /* Make sure the data are on the GPU before handing the objects
+                   over to the main thread */
+                GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+                glDeleteSync(fence);
+
+                {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                    _done.push_back(std::move(job));
+                    _busy = false;
+                }
+                _condition.notify_all();
+            }
+        }
+
+        static void upload(Job& job) {
+            #ifdef Magnum_MeshTools_FOUND
+            if(job.meshData) {
+                /* Using the Array target for indices as well, as there's no
+                   VAO to bind the ElementArray target to in this context */
+                job.vertices = GL::Buffer{GL::Buffer::TargetHint::Array};
+                job.vertices.setData(job.meshData->vertexData());
+                if(job.meshData->isIndexed()) {
+                    job.indices = GL::Buffer{GL::Buffer::TargetHint::Array};
+                    job.indices.setData(job.meshData->indexData());
+                }
+                return;
+            }
+            #endif
+
+            const Vector2i size = job.image.size();
+            job.texture.emplace();
+            job.texture->setStorage(job.generateMipmap ? Int(Math::log2(size.max())) + 1 : 1, job.internalFormat, size)
+                .setSubImage(0, {}, job.image);
+            if(job.generateMipmap) job.texture->generateMipmap();
+        }
+
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        State _state{State::Starting};
+        bool _busy{};
+        std::deque<Job> _queue;
+        std::vector<Job> _done;
+
+        /* Accessed only from the main thread */
+        std::size_t _nextId{};
+        std::unordered_map<std::size_t, PendingJob> _futures;
+};
+#endif
+
+template<class Context, class ContextHandle> void backgroundUploader(py::module& m, ContextHandle(*currentContext)()) {
+    #ifdef MAGNUM_PYTHON_BACKGROUND_UPLOADER
+    py::class_<PyBackgroundUploader<Context, ContextHandle>>{m, "BackgroundUploader", "Background uploader using a shared context"}
+        .def(py::init([currentContext]() {
+            const ContextHandle context = currentContext();
+            if(!context) {
+                PyErr_SetString(PyExc_RuntimeError, "no context is current");
+                throw py::error_already_set{};
+            }
+
+            #ifndef MAGNUM_BUILD_STATIC
+            /* For Texture2D / Mesh in the returned futures. Part of the same
+               module in the static build. */
+            py::module::import("magnum.gl");
+            #endif
+
+            return new PyBackgroundUploader<Context, ContextHandle>{context};
+        }), "Constructor")
+        .def_property_readonly("pending_count", &PyBackgroundUploader<Context, ContextHandle>::pendingCount, "Count of jobs with unresolved futures")
+        .def("upload_texture", &PyBackgroundUploader<Context, ContextHandle>::uploadTexture, "Upload a texture",
+            py::arg("image"), py::arg("internal_format"), py::arg("generate_mipmap") = false)
+        #ifdef Magnum_MeshTools_FOUND
+        .def("upload_mesh", &PyBackgroundUploader<Context, ContextHandle>::uploadMesh, "Upload a mesh", py::arg("mesh_data"))
+        #endif
+        .def("poll", &PyBackgroundUploader<Context, ContextHandle>::poll, "Resolve futures of finished jobs")
+        .def("finish", &PyBackgroundUploader<Context, ContextHandle>::finish, "Wait for all jobs to finish and resolve their futures");
+    #else
+    static_cast<void>(m);
+    static_cast<void>(currentContext);
+    #endif
+}
+
+}}
+
+#endif
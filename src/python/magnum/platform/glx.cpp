@@ -27,7 +27,9 @@
 #include <Magnum/Platform/WindowlessGlxApplication.h>
 
 #include "magnum/bootstrap.h"
+#include "magnum/platform/backgrounduploader.h"
 #include "magnum/platform/windowlessapplication.h"
+#include "magnum/tracing.h"
 
 namespace magnum { namespace platform {
 
@@ -42,6 +44,7 @@ void glx(py::module& m) {
         explicit PyWindowlessApplication(const Configuration& configuration = Configuration{}): Platform::WindowlessApplication{Arguments{argc, nullptr}, configuration} {}
 
         int exec() override {
+            PyTrampolineZone zone{this, "platform", "exec"};
             #ifdef __clang__
             /* ugh pybind don't tell me I AM THE FIRST ON EARTH to get a
                warning here. Why there's no PYBIND11_OVERLOAD_PURE_NAME_ARG()
@@ -67,6 +70,8 @@ void glx(py::module& m) {
     py::class_<PyWindowlessApplication> windowlessGlxApplication{m, "WindowlessApplication", "Windowless GLX application"};
 
     windowlessapplication(windowlessGlxApplication);
+
+    backgroundUploader<Platform::WindowlessGlxContext>(m, glXGetCurrentContext);
 }
 
 }}
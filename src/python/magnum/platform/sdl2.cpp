@@ -30,6 +30,7 @@
 
 #include "magnum/bootstrap.h"
 #include "magnum/platform/application.h"
+#include "magnum/tracing.h"
 
 namespace magnum { namespace platform {
 
@@ -64,6 +65,7 @@ void sdl2(py::module& m) {
         using PublicizedApplication::PublicizedApplication;
 
         void drawEvent() override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "draw_event"};
             #ifdef __clang__
             /* ugh pybind don't tell me I AM THE FIRST ON EARTH to get a
                warning here. Why there's no PYBIND11_OVERLOAD_NAME_ARG()
@@ -87,6 +89,7 @@ void sdl2(py::module& m) {
            That later gets changed to return_value_policy::copy in
            type_caster_base::cast() and there's no way to override that  */
         void keyPressEvent(KeyEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "key_press_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
@@ -98,6 +101,7 @@ void sdl2(py::module& m) {
             );
         }
         void keyReleaseEvent(KeyEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "key_release_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
@@ -110,6 +114,7 @@ void sdl2(py::module& m) {
         }
 
         void mousePressEvent(MouseEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "mouse_press_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
@@ -121,6 +126,7 @@ void sdl2(py::module& m) {
             );
         }
         void mouseReleaseEvent(MouseEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "mouse_release_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
@@ -132,6 +138,7 @@ void sdl2(py::module& m) {
             );
         }
         void mouseMoveEvent(MouseMoveEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "mouse_move_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
@@ -143,6 +150,7 @@ void sdl2(py::module& m) {
             );
         }
         void mouseScrollEvent(MouseScrollEvent& event) override {
+            PyTrampolineZone zone{static_cast<const PublicizedApplication*>(this), "platform", "mouse_scroll_event"};
             PYBIND11_OVERLOAD_NAME(
                 void,
                 PublicizedApplication,
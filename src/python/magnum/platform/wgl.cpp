@@ -28,6 +28,7 @@
 
 #include "magnum/bootstrap.h"
 #include "magnum/platform/windowlessapplication.h"
+#include "magnum/tracing.h"
 
 namespace magnum { namespace platform {
 
@@ -42,6 +43,7 @@ void wgl(py::module& m) {
         explicit PyWindowlessApplication(const Configuration& configuration = Configuration{}): Platform::WindowlessApplication{Arguments{argc, nullptr}, configuration} {}
 
         int exec() override {
+            PyTrampolineZone zone{this, "platform", "exec"};
             #ifdef __clang__
             /* ugh pybind don't tell me I AM THE FIRST ON EARTH to get a
                warning here. Why there's no PYBIND11_OVERLOAD_PURE_NAME_ARG()
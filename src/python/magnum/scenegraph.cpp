@@ -29,6 +29,7 @@
 #include <Magnum/SceneGraph/AbstractObject.h>
 
 #include "magnum/scenegraph.h"
+#include "magnum/tracing.h"
 
 namespace magnum {
 
@@ -38,6 +39,7 @@ template<UnsignedInt dimensions, class T> struct PyDrawable: SceneGraph::PyFeatu
     explicit PyDrawable(SceneGraph::AbstractObject<dimensions, T>& object, SceneGraph::DrawableGroup<dimensions, T>* drawables): SceneGraph::PyFeature<SceneGraph::Drawable<dimensions, T>>{object, drawables} {}
 
     void draw(const MatrixTypeFor<dimensions, T>& transformationMatrix, SceneGraph::Camera<dimensions, T>& camera) override {
+        PyTrampolineZone zone{this, "scenegraph", "Drawable.draw"};
         PYBIND11_OVERLOAD_PURE_NAME(
             void,
             PyDrawable,
@@ -123,8 +125,10 @@ template<UnsignedInt dimensions, class T> void camera(py::class_<SceneGraph::Cam
         .def_property("viewport", &SceneGraph::Camera<dimensions, T>::viewport,
             &SceneGraph::Camera<dimensions, T>::setViewport,
             "Viewport size")
-        .def("draw", static_cast<void(SceneGraph::Camera<dimensions, T>::*)(SceneGraph::DrawableGroup<dimensions, T>&)>(&SceneGraph::Camera<dimensions, T>::draw),
-            "Draw");
+        .def("draw", [](SceneGraph::Camera<dimensions, T>& self, SceneGraph::DrawableGroup<dimensions, T>& group) {
+            PyTraceZone zone{"scenegraph", "Camera.draw"};
+            self.draw(group);
+        }, "Draw");
 }
 
 }
@@ -23,19 +23,27 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstddef>
+#include <cstring>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> /* for vector arguments */
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Shaders/Flat.h>
+#include <Magnum/Shaders/Generic.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Shaders/VertexColor.h>
 
 #include "Corrade/Python.h"
+#include "Magnum/GL/Python.h"
 
 #include "corrade/EnumOperators.h"
 #include "magnum/bootstrap.h"
@@ -44,35 +52,359 @@ namespace magnum {
 
 namespace {
 
-template<class T> void anyShader(PyNonDestructibleClass<T, GL::AbstractShaderProgram>& c) {
-    c.def("draw", static_cast<void(GL::AbstractShaderProgram::*)(GL::Mesh&)>(&GL::AbstractShaderProgram::draw), "Draw a mesh");
+/* State for the opt-in uniform caching. Each shader subclass below keeps the
+   last value set for every uniform and skips the GL call if the new value is
+   the same. */
+struct UniformCache {
+    bool enabled{};
+    UnsignedLong skipped{};
+};
+
+template<class T> struct CachedUniform {
+    T value{};
+    bool valid{};
+};
+
+/* Returns false if the GL call can be skipped, updates the cached value
+   otherwise. Comparing the bits and not using operator== as that does a
+   fuzzy compare, which would skip updates with small changes. */
+template<class T> bool uniformChanged(UniformCache& cache, CachedUniform<T>& cached, const T& value) {
+    if(!cache.enabled) return true;
+
+    if(cached.valid && std::memcmp(&cached.value, &value, sizeof(T)) == 0) {
+        ++cache.skipped;
+        return false;
+    }
+
+    cached.value = value;
+    cached.valid = true;
+    return true;
 }
 
-template<UnsignedInt dimensions> void flat(PyNonDestructibleClass<Shaders::Flat<dimensions>, GL::AbstractShaderProgram>& c) {
+template<class T> struct CachedUniformArray {
+    Containers::Array<T> value;
+    bool valid{};
+};
+
+template<class T> bool uniformChanged(UniformCache& cache, CachedUniformArray<T>& cached, Containers::ArrayView<const T> value) {
+    if(!cache.enabled) return true;
+
+    if(cached.valid && cached.value.size() == value.size() && std::memcmp(cached.value.data(), value.data(), value.size()*sizeof(T)) == 0) {
+        ++cache.skipped;
+        return false;
+    }
+
+    if(cached.value.size() != value.size())
+        cached.value = Containers::Array<T>{Containers::NoInit, value.size()};
+    std::memcpy(cached.value.data(), value.data(), value.size()*sizeof(T));
+    cached.valid = true;
+    return true;
+}
+
+/* Always created instead of the base classes through py::init_alias() so the
+   setters can static_cast to them. Not virtual overrides of anything, so
+   there's no trampolining cost. */
+template<UnsignedInt dimensions> struct PyFlat: Shaders::Flat<dimensions> {
+    #ifndef MAGNUM_TARGET_GLES2
+    explicit PyFlat(typename Shaders::Flat<dimensions>::Flags flags, UnsignedInt materialCount, UnsignedInt drawCount): Shaders::Flat<dimensions>{flags, materialCount, drawCount} {}
+    #else
+    explicit PyFlat(typename Shaders::Flat<dimensions>::Flags flags): Shaders::Flat<dimensions>{flags} {}
+    #endif
+
+    void invalidateUniformCache() {
+        transformationProjectionMatrix.valid = false;
+        textureMatrix.valid = false;
+        color.valid = false;
+        alphaMask.valid = false;
+    }
+
+    UniformCache uniformCache;
+    CachedUniform<MatrixTypeFor<dimensions, Float>> transformationProjectionMatrix;
+    CachedUniform<Matrix3> textureMatrix;
+    CachedUniform<Color4> color;
+    CachedUniform<Float> alphaMask;
+};
+
+struct PyPhong: Shaders::Phong {
+    #ifndef MAGNUM_TARGET_GLES2
+    explicit PyPhong(Shaders::Phong::Flags flags, UnsignedInt lightCount, UnsignedInt materialCount, UnsignedInt drawCount): Shaders::Phong{flags, lightCount, materialCount, drawCount} {}
+    #else
+    explicit PyPhong(Shaders::Phong::Flags flags, UnsignedInt lightCount): Shaders::Phong{flags, lightCount} {}
+    #endif
+
+    void invalidateUniformCache() {
+        ambientColor.valid = false;
+        diffuseColor.valid = false;
+        specularColor.valid = false;
+        shininess.valid = false;
+        alphaMask.valid = false;
+        transformationMatrix.valid = false;
+        normalMatrix.valid = false;
+        projectionMatrix.valid = false;
+        textureMatrix.valid = false;
+        lightPositions.valid = false;
+        lightColors.valid = false;
+    }
+
+    UniformCache uniformCache;
+    CachedUniform<Color4> ambientColor;
+    CachedUniform<Color4> diffuseColor;
+    CachedUniform<Color4> specularColor;
+    CachedUniform<Float> shininess;
+    CachedUniform<Float> alphaMask;
+    CachedUniform<Matrix4> transformationMatrix;
+    CachedUniform<Matrix3x3> normalMatrix;
+    CachedUniform<Matrix4> projectionMatrix;
+    CachedUniform<Matrix3> textureMatrix;
+    CachedUniformArray<Vector3> lightPositions;
+    CachedUniformArray<Color4> lightColors;
+};
+
+/* Light positions and colors can be either a list or anything that supports
+   the buffer protocol, such as a (N, 3) float32 numpy array. If the buffer
+   memory layout matches the C++ type, it's passed to the shader directly
+   without any conversion or copy. */
+template<class T> void setLightArray(PyPhong& self, py::handle value, CachedUniformArray<T>& cached, void(*set)(Shaders::Phong&, Containers::ArrayView<const T>)) {
+    const UnsignedInt count = self.lightCount();
+
+    /* GCC 4.8 otherwise loudly complains about missing initializers */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+    std::vector<T> list;
+    Containers::Array<T> converted;
+    Containers::ArrayView<const T> data;
+
+    if(PyObject_CheckBuffer(value.ptr())) {
+        if(PyObject_GetBuffer(value.ptr(), &buffer, PyBUF_FORMAT|PyBUF_STRIDES) != 0)
+            throw py::error_already_set{};
+
+        if(buffer.ndim != 2) {
+            PyErr_Format(PyExc_BufferError, "expected 2 dimensions but got %i", buffer.ndim);
+            throw py::error_already_set{};
+        }
+
+        if(std::size_t(buffer.shape[0]) != count) {
+            PyErr_Format(PyExc_ValueError, "expected %u items but got %u", count, UnsignedInt(buffer.shape[0]));
+            throw py::error_already_set{};
+        }
+
+        if(std::size_t(buffer.shape[1]) != T::Size) {
+            PyErr_Format(PyExc_BufferError, "expected %zu components but got %zi", std::size_t(T::Size), buffer.shape[1]);
+            throw py::error_already_set{};
+        }
+
+        /* Expecting just an one-letter format */
+        if(!buffer.format[0] || buffer.format[1] || (buffer.format[0] != 'f' && buffer.format[0] != 'd')) {
+            PyErr_Format(PyExc_BufferError, "expected format f or d but got %s", buffer.format);
+            throw py::error_already_set{};
+        }
+
+        /* Layout matches, use the memory directly */
+        if(buffer.format[0] == 'f' && buffer.strides[1] == sizeof(Float) && buffer.strides[0] == sizeof(T)) {
+            data = {static_cast<const T*>(buffer.buf), count};
+
+        /* Otherwise convert */
+        } else {
+            converted = Containers::Array<T>{Containers::NoInit, count};
+            for(std::size_t i = 0; i != count; ++i) {
+                const char* item = static_cast<const char*>(buffer.buf) + i*buffer.strides[0];
+                for(std::size_t j = 0; j != T::Size; ++j) {
+                    const char* component = item + j*buffer.strides[1];
+                    converted[i][j] = buffer.format[0] == 'f' ?
+                        *reinterpret_cast<const Float*>(component) :
+                        Float(*reinterpret_cast<const Double*>(component));
+                }
+            }
+            data = converted;
+        }
+
+    /* Sequences of vectors or tuples, which can't be passed through
+       directly */
+    } else {
+        list = py::cast<std::vector<T>>(value);
+        if(list.size() != count) {
+            PyErr_Format(PyExc_ValueError, "expected %u items but got %u", count, UnsignedInt(list.size()));
+            throw py::error_already_set{};
+        }
+        data = list;
+    }
+
+    if(uniformChanged(self.uniformCache, cached, data)) set(self, data);
+}
+
+/* Python-side API for the uniform caching, common for all shaders that
+   support it */
+template<class Alias, class T, class ...Args> void uniformCaching(py::class_<T, Args...>& c) {
+    c
+        .def_property("uniform_caching", [](T& self) {
+            return static_cast<Alias&>(self).uniformCache.enabled;
+        }, [](T& self, bool enabled) {
+            Alias& alias = static_cast<Alias&>(self);
+            alias.uniformCache.enabled = enabled;
+            alias.invalidateUniformCache();
+        }, "Skip uniform updates that don't change the value")
+        .def_property_readonly("skipped_uniform_updates", [](T& self) {
+            return static_cast<Alias&>(self).uniformCache.skipped;
+        }, "Count of uniform updates skipped due to uniform caching")
+        .def("invalidate_uniform_cache", [](T& self) {
+            static_cast<Alias&>(self).invalidateUniformCache();
+        }, "Invalidate cached uniform values");
+}
+
+/* Classic uniform setters and uniform buffer bindings are mutually exclusive,
+   raising instead of letting Magnum assert */
+template<class T> void checkNoUniformBuffers(const T& self) {
+    #ifndef MAGNUM_TARGET_GLES2
+    if(self.flags() & T::Flag::UniformBuffers) {
+        PyErr_SetString(PyExc_AttributeError, "the shader was created with uniform buffers enabled");
+        throw py::error_already_set{};
+    }
+    #else
+    static_cast<void>(self);
+    #endif
+}
+
+#ifndef MAGNUM_TARGET_GLES2
+template<class T> void checkUniformBuffers(const T& self) {
+    if(!(self.flags() & T::Flag::UniformBuffers)) {
+        PyErr_SetString(PyExc_AttributeError, "the shader was not created with uniform buffers enabled");
+        throw py::error_already_set{};
+    }
+}
+
+/* Layout of an uniform buffer structure in a form accepted by the dict
+   variant of numpy.dtype(), so users can fill the buffers from structured
+   arrays without depending on numpy here. Padding is left out. */
+struct UniformField {
+    const char* name;
+    const char* format;
+    std::size_t offset;
+};
+
+py::dict uniformDtype(std::initializer_list<UniformField> fields, std::size_t size) {
+    py::list names, formats, offsets;
+    for(const UniformField& field: fields) {
+        names.append(field.name);
+        formats.append(field.format);
+        offsets.append(field.offset);
+    }
+
+    py::dict out;
+    out["names"] = names;
+    out["formats"] = formats;
+    out["offsets"] = offsets;
+    out["itemsize"] = size;
+    return out;
+}
+
+py::dict textureTransformationUniformDtype() {
+    return uniformDtype({
+        {"rotation_scaling", "(4,)<f4", offsetof(Shaders::TextureTransformationUniform, rotationScaling)},
+        {"offset", "(2,)<f4", offsetof(Shaders::TextureTransformationUniform, offset)},
+        {"layer", "<u4", offsetof(Shaders::TextureTransformationUniform, layer)}
+    }, sizeof(Shaders::TextureTransformationUniform));
+}
+
+/* Bindings of the uniform buffers, both whole and a range */
+template<class T> using BindBuffer = T&(T::*)(GL::Buffer&);
+template<class T> using BindBufferRange = T&(T::*)(GL::Buffer&, GLintptr, GLsizeiptr);
+
+template<class T, class ...Args> void bindUniformBuffer(py::class_<T, Args...>& c, const char* name, BindBuffer<T> bind, BindBufferRange<T> bindRange, const char* docstring) {
+    c
+        .def(name, [bind](T& self, GL::Buffer& buffer) {
+            checkUniformBuffers(self);
+            (self.*bind)(buffer);
+        }, docstring, py::arg("buffer"))
+        .def(name, [bindRange](T& self, GL::Buffer& buffer, GLintptr offset, GLsizeiptr size) {
+            checkUniformBuffers(self);
+            (self.*bindRange)(buffer, offset, size);
+        }, docstring, py::arg("buffer"), py::arg("offset"), py::arg("size"));
+}
+
+/* Common for all shaders with uniform buffer support */
+template<class T, class ...Args> void uniformBuffers(py::class_<T, Args...>& c) {
+    c
+        .def_property_readonly("material_count", &T::materialCount, "Material count")
+        .def_property_readonly("draw_count", &T::drawCount, "Draw count")
+        .def_property("draw_offset", nullptr, [](T& self, UnsignedInt offset) {
+            checkUniformBuffers(self);
+            if(offset >= self.drawCount()) {
+                PyErr_Format(PyExc_ValueError, "draw offset %u out of bounds for %u draws", offset, self.drawCount());
+                throw py::error_already_set{};
+            }
+
+            self.setDrawOffset(offset);
+        }, "Draw offset");
+}
+#endif
+
+template<class T, class ...Args> void anyShader(py::class_<T, Args...>& c) {
+    c
+        .def("draw", static_cast<void(GL::AbstractShaderProgram::*)(GL::Mesh&)>(&GL::AbstractShaderProgram::draw), "Draw a mesh")
+        /* Together with the MULTI_DRAW flag each view gets a different
+           gl_DrawID, otherwise it's just a convenience */
+        .def("draw", GL::pyMultiDraw, "Draw multiple mesh views at once", py::arg("meshes"));
+}
+
+template<UnsignedInt dimensions> void flat(PyNonDestructibleClass<Shaders::Flat<dimensions>, GL::AbstractShaderProgram, PyFlat<dimensions>>& c) {
     /* Attributes */
     c.attr("TEXTURE_COORDINATES") = GL::DynamicAttribute{typename Shaders::Flat<dimensions>::TextureCoordinates{}};
     c.attr("COLOR3") = GL::DynamicAttribute{typename Shaders::Flat<dimensions>::Color3{}};
     c.attr("COLOR4") = GL::DynamicAttribute{typename Shaders::Flat<dimensions>::Color4{}};
+    c.attr("TRANSFORMATION_MATRIX") = GL::DynamicAttribute{typename Shaders::Flat<dimensions>::TransformationMatrix{}};
+    c.attr("TEXTURE_OFFSET") = GL::DynamicAttribute{typename Shaders::Flat<dimensions>::TextureOffset{}};
 
     /* Methods */
     c
-        .def(py::init<typename Shaders::Flat<dimensions>::Flag>(), "Constructor",
+        #ifndef MAGNUM_TARGET_GLES2
+        .def(py::init_alias<typename Shaders::Flat<dimensions>::Flag, UnsignedInt, UnsignedInt>(), "Constructor",
+            py::arg("flags") = typename Shaders::Flat<dimensions>::Flag{},
+            py::arg("material_count") = 1,
+            py::arg("draw_count") = 1)
+        #else
+        .def(py::init_alias<typename Shaders::Flat<dimensions>::Flag>(), "Constructor",
             py::arg("flags") = typename Shaders::Flat<dimensions>::Flag{})
+        #endif
 
         /* Using lambdas to avoid method chaining getting into signatures */
         .def_property_readonly("flags", [](Shaders::Flat<dimensions>& self) {
-            return typename Shaders::Flat<dimensions>::Flag(UnsignedByte(self.flags()));
+            return typename Shaders::Flat<dimensions>::Flag(typename std::underlying_type<typename Shaders::Flat<dimensions>::Flag>::type(self.flags()));
         }, "Flags")
-        .def_property("transformation_projection_matrix", nullptr, &Shaders::Flat<dimensions>::setTransformationProjectionMatrix,
-            "Transformation and projection matrix")
-        .def_property("color", nullptr, &Shaders::Flat<dimensions>::setColor, "Color")
+        .def_property("transformation_projection_matrix", nullptr, [](Shaders::Flat<dimensions>& self, const MatrixTypeFor<dimensions, Float>& matrix) {
+            checkNoUniformBuffers(self);
+            PyFlat<dimensions>& alias = static_cast<PyFlat<dimensions>&>(self);
+            if(uniformChanged(alias.uniformCache, alias.transformationProjectionMatrix, matrix))
+                self.setTransformationProjectionMatrix(matrix);
+        }, "Transformation and projection matrix")
+        .def_property("texture_matrix", nullptr, [](Shaders::Flat<dimensions>& self, const Matrix3& matrix) {
+            if(!(self.flags() & Shaders::Flat<dimensions>::Flag::TextureTransformation)) {
+                PyErr_SetString(PyExc_AttributeError, "the shader was not created with texture transformation enabled");
+                throw py::error_already_set{};
+            }
+
+            checkNoUniformBuffers(self);
+
+            PyFlat<dimensions>& alias = static_cast<PyFlat<dimensions>&>(self);
+            if(uniformChanged(alias.uniformCache, alias.textureMatrix, matrix))
+                self.setTextureMatrix(matrix);
+        }, "Texture coordinate transformation matrix")
+        .def_property("color", nullptr, [](Shaders::Flat<dimensions>& self, const Color4& color) {
+            checkNoUniformBuffers(self);
+            PyFlat<dimensions>& alias = static_cast<PyFlat<dimensions>&>(self);
+            if(uniformChanged(alias.uniformCache, alias.color, color))
+                self.setColor(color);
+        }, "Color")
         .def_property("alpha_mask", nullptr, [](Shaders::Flat<dimensions>& self, Float mask) {
             if(!(self.flags() & Shaders::Flat<dimensions>::Flag::AlphaMask)) {
                 PyErr_SetString(PyExc_AttributeError, "the shader was not created with alpha mask enabled");
                 throw py::error_already_set{};
             }
 
-            self.setAlphaMask(mask);
+            checkNoUniformBuffers(self);
+
+            PyFlat<dimensions>& alias = static_cast<PyFlat<dimensions>&>(self);
+            if(uniformChanged(alias.uniformCache, alias.alphaMask, mask))
+                self.setAlphaMask(mask);
         }, "Alpha mask")
         .def("bind_texture", [](Shaders::Flat<dimensions>& self, GL::Texture2D& texture) {
             if(!(self.flags() & Shaders::Flat<dimensions>::Flag::Textured)) {
@@ -83,6 +415,38 @@ template<UnsignedInt dimensions> void flat(PyNonDestructibleClass<Shaders::Flat<
             self.bindTexture(texture);
         }, "Bind a color texture");
 
+    #ifndef MAGNUM_TARGET_GLES2
+    uniformBuffers(c);
+    bindUniformBuffer<Shaders::Flat<dimensions>>(c, "bind_transformation_projection_buffer",
+        &Shaders::Flat<dimensions>::bindTransformationProjectionBuffer,
+        &Shaders::Flat<dimensions>::bindTransformationProjectionBuffer,
+        "Bind a transformation and projection uniform buffer");
+    bindUniformBuffer<Shaders::Flat<dimensions>>(c, "bind_draw_buffer",
+        &Shaders::Flat<dimensions>::bindDrawBuffer,
+        &Shaders::Flat<dimensions>::bindDrawBuffer,
+        "Bind a draw uniform buffer");
+    bindUniformBuffer<Shaders::Flat<dimensions>>(c, "bind_texture_transformation_buffer",
+        &Shaders::Flat<dimensions>::bindTextureTransformationBuffer,
+        &Shaders::Flat<dimensions>::bindTextureTransformationBuffer,
+        "Bind a texture transformation uniform buffer");
+    bindUniformBuffer<Shaders::Flat<dimensions>>(c, "bind_material_buffer",
+        &Shaders::Flat<dimensions>::bindMaterialBuffer,
+        &Shaders::Flat<dimensions>::bindMaterialBuffer,
+        "Bind a material uniform buffer");
+
+    /* Uniform structure layouts */
+    c.attr("DRAW_UNIFORM") = uniformDtype({
+        {"material_id", "<u2", offsetof(Shaders::FlatDrawUniform, materialId)},
+        {"object_id", "<u4", offsetof(Shaders::FlatDrawUniform, objectId)}
+    }, sizeof(Shaders::FlatDrawUniform));
+    c.attr("MATERIAL_UNIFORM") = uniformDtype({
+        {"color", "(4,)<f4", offsetof(Shaders::FlatMaterialUniform, color)},
+        {"alpha_mask", "<f4", offsetof(Shaders::FlatMaterialUniform, alphaMask)}
+    }, sizeof(Shaders::FlatMaterialUniform));
+    c.attr("TEXTURE_TRANSFORMATION_UNIFORM") = textureTransformationUniformDtype();
+    #endif
+
+    uniformCaching<PyFlat<dimensions>>(c);
     anyShader(c);
 }
 
@@ -116,12 +480,20 @@ void shaders(py::module& m) {
 
     /* 2D/3D flat shader */
     {
-        PyNonDestructibleClass<Shaders::Flat2D, GL::AbstractShaderProgram> flat2D{m,
+        PyNonDestructibleClass<Shaders::Flat2D, GL::AbstractShaderProgram, PyFlat<2>> flat2D{m,
             "Flat2D", "2D flat shader"};
-        PyNonDestructibleClass<Shaders::Flat3D, GL::AbstractShaderProgram> flat3D{m,
+        PyNonDestructibleClass<Shaders::Flat3D, GL::AbstractShaderProgram, PyFlat<3>> flat3D{m,
             "Flat3D", "3D flat shader"};
         flat2D.attr("POSITION") = GL::DynamicAttribute{Shaders::Flat2D::Position{}};
         flat3D.attr("POSITION") = GL::DynamicAttribute{Shaders::Flat3D::Position{}};
+        #ifndef MAGNUM_TARGET_GLES2
+        flat2D.attr("TRANSFORMATION_PROJECTION_UNIFORM") = uniformDtype({
+            {"transformation_projection_matrix", "(3,4)<f4", offsetof(Shaders::TransformationProjectionUniform2D, transformationProjectionMatrix)}
+        }, sizeof(Shaders::TransformationProjectionUniform2D));
+        flat3D.attr("TRANSFORMATION_PROJECTION_UNIFORM") = uniformDtype({
+            {"transformation_projection_matrix", "(4,4)<f4", offsetof(Shaders::TransformationProjectionUniform3D, transformationProjectionMatrix)}
+        }, sizeof(Shaders::TransformationProjectionUniform3D));
+        #endif
 
         /* The flags are currently the same type for both 2D and 3D and pybind
            doesn't want to have a single type registered twice, so doing it
@@ -130,8 +502,15 @@ void shaders(py::module& m) {
         flags
             .value("TEXTURED", Shaders::Flat2D::Flag::Textured)
             .value("ALPHA_MASK", Shaders::Flat2D::Flag::AlphaMask)
-            .value("VERTEX_COLOR", Shaders::Flat3D::Flag::AlphaMask)
-            .value("NONE", Shaders::Flat3D::Flag{})
+            .value("VERTEX_COLOR", Shaders::Flat2D::Flag::VertexColor)
+            .value("TEXTURE_TRANSFORMATION", Shaders::Flat2D::Flag::TextureTransformation)
+            .value("INSTANCED_TRANSFORMATION", Shaders::Flat2D::Flag::InstancedTransformation)
+            .value("INSTANCED_TEXTURE_OFFSET", Shaders::Flat2D::Flag::InstancedTextureOffset)
+            #ifndef MAGNUM_TARGET_GLES2
+            .value("UNIFORM_BUFFERS", Shaders::Flat2D::Flag::UniformBuffers)
+            .value("MULTI_DRAW", Shaders::Flat2D::Flag::MultiDraw)
+            #endif
+            .value("NONE", Shaders::Flat2D::Flag{})
             /* TODO: OBJECT_ID, once multiple FB outputs and mapDraw is exposed */
             ;
         flat3D.attr("Flags") = flags;
@@ -157,7 +536,7 @@ void shaders(py::module& m) {
 
     /* Phong shader */
     {
-        PyNonDestructibleClass<Shaders::Phong, GL::AbstractShaderProgram> phong{m,
+        PyNonDestructibleClass<Shaders::Phong, GL::AbstractShaderProgram, PyPhong> phong{m,
             "Phong", "Phong shader"};
         phong.attr("POSITION") = GL::DynamicAttribute{Shaders::Phong::Position{}};
         phong.attr("NORMAL") = GL::DynamicAttribute{Shaders::Phong::Normal{}};
@@ -165,6 +544,9 @@ void shaders(py::module& m) {
         phong.attr("TEXTURE_COORDINATES") = GL::DynamicAttribute{Shaders::Phong::TextureCoordinates{}};
         phong.attr("COLOR3") = GL::DynamicAttribute{Shaders::Phong::Color3{}};
         phong.attr("COLOR4") = GL::DynamicAttribute{Shaders::Phong::Color4{}};
+        phong.attr("TRANSFORMATION_MATRIX") = GL::DynamicAttribute{Shaders::Phong::TransformationMatrix{}};
+        phong.attr("NORMAL_MATRIX") = GL::DynamicAttribute{Shaders::Phong::NormalMatrix{}};
+        phong.attr("TEXTURE_OFFSET") = GL::DynamicAttribute{Shaders::Phong::TextureOffset{}};
 
         py::enum_<Shaders::Phong::Flag> flags{phong, "Flags", "Flags"};
 
@@ -175,57 +557,115 @@ void shaders(py::module& m) {
             .value("NORMAL_TEXTURE", Shaders::Phong::Flag::NormalTexture)
             .value("ALPHA_MASK", Shaders::Phong::Flag::AlphaMask)
             .value("VERTEX_COLOR", Shaders::Phong::Flag::VertexColor)
+            .value("TEXTURE_TRANSFORMATION", Shaders::Phong::Flag::TextureTransformation)
+            .value("INSTANCED_TRANSFORMATION", Shaders::Phong::Flag::InstancedTransformation)
+            .value("INSTANCED_TEXTURE_OFFSET", Shaders::Phong::Flag::InstancedTextureOffset)
+            #ifndef MAGNUM_TARGET_GLES2
+            .value("UNIFORM_BUFFERS", Shaders::Phong::Flag::UniformBuffers)
+            .value("MULTI_DRAW", Shaders::Phong::Flag::MultiDraw)
+            #endif
             .value("NONE", Shaders::Phong::Flag{})
             /* TODO: OBJECT_ID, once multiple FB outputs and mapDraw is exposed */
             ;
         corrade::enumOperators(flags);
 
         phong
-            .def(py::init<Shaders::Phong::Flag, UnsignedInt>(), "Constructor",
+            #ifndef MAGNUM_TARGET_GLES2
+            .def(py::init_alias<Shaders::Phong::Flag, UnsignedInt, UnsignedInt, UnsignedInt>(), "Constructor",
+                py::arg("flags") = Shaders::Phong::Flag{},
+                py::arg("light_count") = 1,
+                py::arg("material_count") = 1,
+                py::arg("draw_count") = 1)
+            #else
+            .def(py::init_alias<Shaders::Phong::Flag, UnsignedInt>(), "Constructor",
                 py::arg("flags") = Shaders::Phong::Flag{},
                 py::arg("light_count") = 1)
+            #endif
             .def_property_readonly("flags", [](Shaders::Phong& self) {
-                return Shaders::Phong::Flag(UnsignedShort(self.flags()));
+                return Shaders::Phong::Flag(std::underlying_type<Shaders::Phong::Flag>::type(self.flags()));
             }, "Flags")
             .def_property_readonly("light_count", &Shaders::Phong::lightCount,
                 "Light count")
-            .def_property("ambient_color", nullptr,
-                &Shaders::Phong::setAmbientColor, "Ambient color")
-            .def_property("diffuse_color", nullptr,
-                &Shaders::Phong::setDiffuseColor, "Diffuse color")
-            .def_property("specular_color", nullptr,
-                &Shaders::Phong::setSpecularColor, "Specular color")
-            .def_property("shininess", nullptr,
-                &Shaders::Phong::setShininess, "Shininess")
+            /* Using lambdas to avoid method chaining getting into signatures */
+            .def_property("ambient_color", nullptr, [](Shaders::Phong& self, const Color4& color) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.ambientColor, color))
+                    self.setAmbientColor(color);
+            }, "Ambient color")
+            .def_property("diffuse_color", nullptr, [](Shaders::Phong& self, const Color4& color) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.diffuseColor, color))
+                    self.setDiffuseColor(color);
+            }, "Diffuse color")
+            .def_property("specular_color", nullptr, [](Shaders::Phong& self, const Color4& color) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.specularColor, color))
+                    self.setSpecularColor(color);
+            }, "Specular color")
+            .def_property("shininess", nullptr, [](Shaders::Phong& self, Float shininess) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.shininess, shininess))
+                    self.setShininess(shininess);
+            }, "Shininess")
             .def_property("alpha_mask", nullptr, [](Shaders::Phong& self, Float mask) {
                 if(!(self.flags() & Shaders::Phong::Flag::AlphaMask)) {
                     PyErr_SetString(PyExc_AttributeError, "the shader was not created with alpha mask enabled");
                     throw py::error_already_set{};
                 }
 
-                self.setAlphaMask(mask);
+                checkNoUniformBuffers(self);
+
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.alphaMask, mask))
+                    self.setAlphaMask(mask);
             }, "Alpha mask")
-            .def_property("transformation_matrix", nullptr,
-                &Shaders::Phong::setTransformationMatrix, "Set transformation matrix")
-            .def_property("normal_matrix", nullptr,
-                &Shaders::Phong::setNormalMatrix, "Set normal matrix")
-            .def_property("projection_matrix", nullptr,
-                &Shaders::Phong::setProjectionMatrix, "Set projection matrix")
-            .def_property("light_positions", nullptr, [](Shaders::Phong& self, const std::vector<Vector3>& positions) {
-                if(positions.size() != self.lightCount()) {
-                    PyErr_Format(PyExc_ValueError, "expected %u items but got %u", self.lightCount(), UnsignedInt(positions.size()));
+            .def_property("transformation_matrix", nullptr, [](Shaders::Phong& self, const Matrix4& matrix) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.transformationMatrix, matrix))
+                    self.setTransformationMatrix(matrix);
+            }, "Set transformation matrix")
+            .def_property("normal_matrix", nullptr, [](Shaders::Phong& self, const Matrix3x3& matrix) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.normalMatrix, matrix))
+                    self.setNormalMatrix(matrix);
+            }, "Set normal matrix")
+            .def_property("projection_matrix", nullptr, [](Shaders::Phong& self, const Matrix4& matrix) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.projectionMatrix, matrix))
+                    self.setProjectionMatrix(matrix);
+            }, "Set projection matrix")
+            .def_property("texture_matrix", nullptr, [](Shaders::Phong& self, const Matrix3& matrix) {
+                if(!(self.flags() & Shaders::Phong::Flag::TextureTransformation)) {
+                    PyErr_SetString(PyExc_AttributeError, "the shader was not created with texture transformation enabled");
                     throw py::error_already_set{};
                 }
 
-                self.setLightPositions(positions);
+                checkNoUniformBuffers(self);
+
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                if(uniformChanged(alias.uniformCache, alias.textureMatrix, matrix))
+                    self.setTextureMatrix(matrix);
+            }, "Set texture coordinate transformation matrix")
+            .def_property("light_positions", nullptr, [](Shaders::Phong& self, py::object positions) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                setLightArray<Vector3>(alias, positions, alias.lightPositions, [](Shaders::Phong& shader, Containers::ArrayView<const Vector3> data) {
+                    shader.setLightPositions(data);
+                });
             }, "Light positions")
-            .def_property("light_colors", nullptr, [](Shaders::Phong& self, const std::vector<Color4>& colors) {
-                if(colors.size() != self.lightCount()) {
-                    PyErr_Format(PyExc_ValueError, "expected %u items but got %u", self.lightCount(), UnsignedInt(colors.size()));
-                    throw py::error_already_set{};
-                }
-
-                self.setLightColors(colors);
+            .def_property("light_colors", nullptr, [](Shaders::Phong& self, py::object colors) {
+                checkNoUniformBuffers(self);
+                PyPhong& alias = static_cast<PyPhong&>(self);
+                setLightArray<Color4>(alias, colors, alias.lightColors, [](Shaders::Phong& shader, Containers::ArrayView<const Color4> data) {
+                    shader.setLightColors(data);
+                });
             }, "Light colors")
 
             .def("bind_ambient_texture", [](Shaders::Phong& self, GL::Texture2D& texture) {
@@ -270,6 +710,65 @@ void shaders(py::module& m) {
             }, "Bind textures", py::arg("ambient") = nullptr, py::arg("diffuse") = nullptr, py::arg("specular") = nullptr, py::arg("normal") = nullptr)
             ;
 
+        #ifndef MAGNUM_TARGET_GLES2
+        uniformBuffers(phong);
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_projection_buffer",
+            &Shaders::Phong::bindProjectionBuffer,
+            &Shaders::Phong::bindProjectionBuffer,
+            "Bind a projection uniform buffer");
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_transformation_buffer",
+            &Shaders::Phong::bindTransformationBuffer,
+            &Shaders::Phong::bindTransformationBuffer,
+            "Bind a transformation uniform buffer");
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_draw_buffer",
+            &Shaders::Phong::bindDrawBuffer,
+            &Shaders::Phong::bindDrawBuffer,
+            "Bind a draw uniform buffer");
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_texture_transformation_buffer",
+            &Shaders::Phong::bindTextureTransformationBuffer,
+            &Shaders::Phong::bindTextureTransformationBuffer,
+            "Bind a texture transformation uniform buffer");
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_material_buffer",
+            &Shaders::Phong::bindMaterialBuffer,
+            &Shaders::Phong::bindMaterialBuffer,
+            "Bind a material uniform buffer");
+        bindUniformBuffer<Shaders::Phong>(phong, "bind_light_buffer",
+            &Shaders::Phong::bindLightBuffer,
+            &Shaders::Phong::bindLightBuffer,
+            "Bind a light uniform buffer");
+
+        /* Uniform structure layouts */
+        phong.attr("PROJECTION_UNIFORM") = uniformDtype({
+            {"projection_matrix", "(4,4)<f4", offsetof(Shaders::ProjectionUniform3D, projectionMatrix)}
+        }, sizeof(Shaders::ProjectionUniform3D));
+        phong.attr("TRANSFORMATION_UNIFORM") = uniformDtype({
+            {"transformation_matrix", "(4,4)<f4", offsetof(Shaders::TransformationUniform3D, transformationMatrix)}
+        }, sizeof(Shaders::TransformationUniform3D));
+        phong.attr("DRAW_UNIFORM") = uniformDtype({
+            {"normal_matrix", "(3,4)<f4", offsetof(Shaders::PhongDrawUniform, normalMatrix)},
+            {"material_id", "<u2", offsetof(Shaders::PhongDrawUniform, materialId)},
+            {"object_id", "<u4", offsetof(Shaders::PhongDrawUniform, objectId)},
+            {"light_offset", "<u4", offsetof(Shaders::PhongDrawUniform, lightOffset)},
+            {"light_count", "<u4", offsetof(Shaders::PhongDrawUniform, lightCount)}
+        }, sizeof(Shaders::PhongDrawUniform));
+        phong.attr("MATERIAL_UNIFORM") = uniformDtype({
+            {"ambient_color", "(4,)<f4", offsetof(Shaders::PhongMaterialUniform, ambientColor)},
+            {"diffuse_color", "(4,)<f4", offsetof(Shaders::PhongMaterialUniform, diffuseColor)},
+            {"specular_color", "(4,)<f4", offsetof(Shaders::PhongMaterialUniform, specularColor)},
+            {"normal_texture_scale", "<f4", offsetof(Shaders::PhongMaterialUniform, normalTextureScale)},
+            {"shininess", "<f4", offsetof(Shaders::PhongMaterialUniform, shininess)},
+            {"alpha_mask", "<f4", offsetof(Shaders::PhongMaterialUniform, alphaMask)}
+        }, sizeof(Shaders::PhongMaterialUniform));
+        phong.attr("LIGHT_UNIFORM") = uniformDtype({
+            {"position", "(4,)<f4", offsetof(Shaders::PhongLightUniform, position)},
+            {"color", "(3,)<f4", offsetof(Shaders::PhongLightUniform, color)},
+            {"specular_color", "(3,)<f4", offsetof(Shaders::PhongLightUniform, specularColor)},
+            {"range", "<f4", offsetof(Shaders::PhongLightUniform, range)}
+        }, sizeof(Shaders::PhongLightUniform));
+        phong.attr("TEXTURE_TRANSFORMATION_UNIFORM") = textureTransformationUniformDtype();
+        #endif
+
+        uniformCaching<PyPhong>(phong);
         anyShader(phong);
     }
 }
@@ -33,6 +33,9 @@ sys.path = [os.path.join(os.path.dirname(__file__), os.environ.get('CMAKE_BINARY
 from magnum import *
 from magnum import gl, platform
 
+# Internal hooks, not exported from the magnum package
+import _magnum
+
 try:
     from magnum.platform.glx import WindowlessApplication
 except ImportError:
@@ -67,3 +70,41 @@ class GLTestCase(unittest.TestCase):
 
     def tearDown(self):
         self.assertNoGLError()
+
+class AllocationCounter:
+    """Counts allocations done through the Python allocators in a with block
+
+    That includes Python objects (counted in :py:`objects`) and other
+    allocations through :py:`PyMem_*()` (counted in :py:`allocations`),
+    but not plain :py:`malloc()` or :py:`new` in native code.
+    """
+
+    def __enter__(self):
+        # Tracers such as coverage.py allocate on every executed line
+        self._trace = sys.gettrace()
+        sys.settrace(None)
+        _magnum._start_allocation_counting()
+        return self
+
+    def __exit__(self, *args):
+        counts = _magnum._stop_allocation_counting()
+        sys.settrace(self._trace)
+        self.allocations = counts['allocations']
+        self.objects = counts['objects']
+        self.reallocations = counts['reallocations']
+        self.deallocations = counts['deallocations']
+        self.bytes = counts['bytes']
+
+def allocations_per_call(function, repeat=100):
+    """Average count of allocations and Python objects allocated by a call
+
+    The function is called once before counting, so one-time lazy
+    initialization doesn't count against it. Rounded down, so occasional
+    allocations done by the interpreter itself don't either.
+    """
+    function()
+    with AllocationCounter() as counter:
+        for i in range(repeat):
+            function()
+    return (counter.allocations + counter.objects + counter.reallocations)//repeat
+
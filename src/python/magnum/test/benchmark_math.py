@@ -32,6 +32,7 @@ import timeit
 
 import array
 from magnum import *
+from magnum import math
 import numpy as np
 
 repeats = 100000
@@ -82,6 +83,41 @@ timethat('np.array(a)', setup='a = array.array("f", [1.0, 2.0, 3.0])')
 timethat('np.array(a)', setup='a = Vector3(1.0, 2.0, 3.0)')
 timethat('Vector3(a)', setup='a = np.array([1.0, 2.0, 3.0])')
 
+print("\n  Vector3 to np.array through other protocols:\n")
+
+# Vector3 implements the buffer protocol, which numpy tries before
+# __array_struct__, __array_interface__ and __array__. These proxies expose
+# the same memory through the other protocols to see if any of them would be
+# worth implementing instead. The cached variants are the best case, in
+# practice the dictionary or the array would need to be created for each
+# object.
+class ArrayInterface:
+    def __init__(self, vector):
+        self.vector = vector
+        self.address = np.frombuffer(vector, dtype='f').ctypes.data
+
+    @property
+    def __array_interface__(self):
+        return {'shape': (3,), 'typestr': '<f4', 'data': (self.address, False), 'version': 3}
+
+class CachedArrayInterface:
+    def __init__(self, vector):
+        self.vector = vector
+        self.__array_interface__ = ArrayInterface(vector).__array_interface__
+
+class CachedArray:
+    def __init__(self, vector):
+        self.array = np.frombuffer(vector, dtype='f')
+
+    def __array__(self, dtype=None):
+        return self.array
+
+timethat('np.array(a) # buffer protocol', setup='a = Vector3(1.0, 2.0, 3.0)')
+timethat('np.array(a) # __array_interface__', setup='a = ArrayInterface(Vector3(1.0, 2.0, 3.0))')
+timethat('np.array(a) # cached __array_interface__', setup='a = CachedArrayInterface(Vector3(1.0, 2.0, 3.0))')
+timethat('np.array(a) # cached __array__', setup='a = CachedArray(Vector3(1.0, 2.0, 3.0))')
+timethat('memoryview(a)', setup='a = Vector3(1.0, 2.0, 3.0)')
+
 print("\n  Matrix3 from/to list, equivalent np.array operations:\n")
 
 timethat('Matrix3()')
@@ -105,3 +141,12 @@ timethat('a.dot()', setup='a = Vector4d(1.0, 2.0, 3.0, 4.0)')
 timethat('np.dot(a, a)', setup='a = np.array([1.0, 2.0, 3.0, 4.0])')
 timethat('a@a', setup='a = Matrix4d.from_diagonal([1.0, 2.0, 3.0, 4.0])')
 timethat('a@a', setup='a = np.diagflat([1.0, 2.0, 3.0, 4.0])')
+
+print("\n  transcendental functions on 10k items:\n")
+
+timethat('math.sin(a, out)', setup='a = RadArray(np.linspace(0.0, 10.0, 10000, dtype="f")); out = np.empty(10000, dtype="f")')
+timethat('np.sin(a, out=out)', setup='a = np.linspace(0.0, 10.0, 10000, dtype="f"); out = np.empty(10000, dtype="f")')
+timethat('math.sin(a, out)', setup='a = RadArray(np.linspace(0.0, 10.0, 10000)); out = np.empty(10000)')
+timethat('np.sin(a, out=out)', setup='a = np.linspace(0.0, 10.0, 10000); out = np.empty(10000)')
+timethat('math.atan(a, out)', setup='a = np.linspace(-10.0, 10.0, 10000, dtype="f"); out = RadArray(np.empty(10000, dtype="f"))')
+timethat('np.arctan(a, out=out)', setup='a = np.linspace(-10.0, 10.0, 10000, dtype="f"); out = np.empty(10000, dtype="f")')
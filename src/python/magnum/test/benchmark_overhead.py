@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+
+# Runs the same operations as src/Magnum/Test/BindingOverheadBenchmark.cpp
+# from Python and prints the overhead of the bindings relative to the native
+# code. Usage:
+#
+#   ./benchmark_overhead.py path/to/BindingOverheadBenchmark [history.jsonl]
+#
+# If the history file is given, a record with the results is appended to it,
+# so the overhead can be tracked over time.
+
+# Avoid this being run implicitly during unit tests
+if __name__ != '__main__': exit()
+
+import datetime
+import json
+import os
+import re
+import subprocess
+import sys
+import timeit
+
+from corrade import containers
+from magnum import *
+from magnum import math, trade
+
+if len(sys.argv) not in [2, 3]:
+    print(f"usage: {sys.argv[0]} path/to/BindingOverheadBenchmark [history.jsonl]")
+    exit(1)
+
+rgb_png = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'rgb.png')
+
+# Name of the native benchmark -> (expression, setup, repeats). Keep in sync
+# with the C++ side.
+benchmarks = {
+    'vectorAdd': ('a + b', 'a = Vector3(1.0, 2.0, 3.0); b = Vector3.x_axis()', 100000),
+    'vectorDot': ('math.dot(a, a)', 'a = Vector3(1.0, 2.0, 3.0)', 100000),
+    'matrixMultiply': ('a@b', 'a = Matrix4.translation((1.0, 2.0, 3.0)); b = Matrix4.translation(Vector3.x_axis())', 100000),
+    'matrixInverted': ('a.inverted()', 'a = Matrix4.translation((1.0, 2.0, 3.0))@Matrix4.scaling((2.0, 4.0, 0.5))', 100000),
+    'arrayViewSlice': ('a[1:5]', 'a = containers.ArrayView(b"hello world")', 100000),
+    'stridedArrayViewSlice': ('a[1:5]', 'a = containers.StridedArrayView1D(b"hello world")', 100000),
+    'importerOpenFile': ('importer.open_file(rgb_png)', 'importer = trade.ImporterManager().load_and_instantiate("StbImageImporter")', 100),
+    'importerImage2D': ('importer.image2d(0)', 'importer = trade.ImporterManager().load_and_instantiate("StbImageImporter"); importer.open_file(rgb_png)', 100),
+}
+
+units = {'ns': 1.0e-9, 'µs': 1.0e-6, 'ms': 1.0e-3, 's': 1.0}
+
+# Corrade TestSuite prints e.g. `BENCH [01]   12.34 ± 0.56   ns vectorAdd()@9x10000 (wall time)`,
+# with the time being per iteration. Skipped benchmarks are not listed.
+native = {}
+output = subprocess.run([sys.argv[1], '--only-benchmarks', '--color', 'off'], stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+for line in output.splitlines():
+    match = re.search(r'BENCH \[\d+\]\s+([0-9.]+)\s+±\s+[0-9.]+\s+(ns|µs|ms|s)\s+(\w+)\(\)', line)
+    if match: native[match.group(3)] = float(match.group(1))*units[match.group(2)]
+
+print('{:24} {:>12} {:>12} {:>8}'.format('', 'native', 'python', 'ratio'))
+
+results = {}
+for name, (expr, setup, repeats) in benchmarks.items():
+    if name not in native:
+        print('{:24} {:>12}'.format(name, 'skipped'))
+        continue
+
+    python = timeit.timeit(expr, setup=setup, number=repeats, globals=globals())/repeats
+    results[name] = {
+        'native': native[name],
+        'python': python,
+        'ratio': python/native[name] if native[name] else None
+    }
+    print('{:24} {:9.3f} µs {:9.3f} µs {:>8}'.format(name, native[name]*1.0e6, python*1.0e6, '{:.1f}x'.format(results[name]['ratio']) if results[name]['ratio'] else '-'))
+
+if len(sys.argv) == 3:
+    with open(sys.argv[2], 'a') as f:
+        f.write(json.dumps({
+            'date': datetime.datetime.now().isoformat(),
+            'python': sys.version.split()[0],
+            'results': results
+        }) + '\n')
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+
+# Avoid this being run implicitly during unit tests
+if __name__ != '__main__': exit()
+
+import timeit
+
+import array
+from magnum import *
+from magnum import gl, meshtools, primitives, shaders
+
+try:
+    from magnum.platform.glx import WindowlessApplication
+except ImportError:
+    try:
+        from magnum.platform.wgl import WindowlessApplication
+    except ImportError:
+        from magnum.platform.egl import WindowlessApplication
+
+app = WindowlessApplication()
+
+repeats = 100
+instances = 1000
+
+def timethat(expr: str, *, setup:str = 'pass', title=None):
+    if not title:
+        if setup != 'pass': title = f'{setup}; {expr}'
+        else: title = expr
+
+    # Wait for the GPU to finish so the time isn't just the command submission
+    expr = f'{expr}; gl.Renderer.finish()'
+
+    print('{:67} {:8.3f} ms'.format(title, timeit.timeit(expr, number=repeats, globals=globals(), setup=setup)*1000.0/repeats))
+
+framebuffer = gl.Framebuffer(((0, 0), (256, 256)))
+color = gl.Renderbuffer()
+color.set_storage(gl.RenderbufferFormat.RGBA8, (256, 256))
+framebuffer.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), color)
+framebuffer.bind()
+
+transformations = [Matrix4.translation(Vector3(i % 32, i // 32, 0.0)*0.06 - Vector3(1.0, 1.0, 0.0))@Matrix4.scaling(Vector3(0.02)) for i in range(instances)]
+colors = [Color4(i/instances, 1.0 - i/instances, 0.5) for i in range(instances)]
+
+mesh = meshtools.compile(primitives.cube_solid())
+flat = shaders.Flat3D()
+flat_cached = shaders.Flat3D()
+flat_cached.uniform_caching = True
+
+instanced_data = array.array('f')
+for transformation in transformations:
+    for column in range(4):
+        instanced_data.extend(transformation[column])
+instanced_buffer = gl.Buffer()
+instanced_buffer.set_data(instanced_data)
+instanced_mesh = meshtools.compile(primitives.cube_solid())
+instanced_mesh.instance_count = instances
+instanced_mesh.add_vertex_buffer_instanced(instanced_buffer, 1, 0, 64, shaders.Flat3D.TRANSFORMATION_MATRIX)
+flat_instanced = shaders.Flat3D(shaders.Flat3D.Flags.INSTANCED_TRANSFORMATION)
+
+def draw_individually(shader):
+    for i in range(instances):
+        shader.transformation_projection_matrix = transformations[i]
+        shader.color = colors[0]
+        shader.draw(mesh)
+
+print(f"  {instances} cubes, {repeats} repeats:\n")
+
+timethat('draw_individually(flat)')
+timethat('draw_individually(flat_cached)')
+timethat('flat_instanced.draw(instanced_mesh)')
@@ -23,9 +23,14 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import json
+import os
+import subprocess
 import sys
+import tempfile
 import unittest
 
+import magnum
 from magnum import *
 
 class PixelStorage_(unittest.TestCase):
@@ -109,6 +114,28 @@ class Image(unittest.TestCase):
         self.assertIs(pixels.owner, None)
         self.assertEqual(sys.getrefcount(a), a_refcount)
 
+class CpuDispatch(unittest.TestCase):
+    def run_with(self, level):
+        env = dict(os.environ)
+        env['MAGNUM_CPU_DISPATCH'] = level
+        env['PYTHONPATH'] = os.pathsep.join(sys.path)
+        return subprocess.run([sys.executable, '-c', 'import magnum; print(magnum.CPU_DISPATCH)'], env=env, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+
+    def test(self):
+        self.assertIn(magnum.CPU_DISPATCH, ['scalar', 'sse2', 'avx2', 'avx512', 'neon'])
+
+    def test_override(self):
+        # Can only lower the level
+        self.assertEqual(self.run_with('scalar').stdout.strip(), 'scalar')
+        if magnum.CPU_DISPATCH in ['avx2', 'avx512']:
+            self.assertEqual(self.run_with('sse2').stdout.strip(), 'sse2')
+        self.assertEqual(self.run_with('avx512').stdout.strip(), magnum.CPU_DISPATCH if magnum.CPU_DISPATCH != 'neon' else 'scalar')
+
+    def test_override_invalid(self):
+        result = self.run_with('mmx')
+        self.assertNotEqual(result.returncode, 0)
+        self.assertIn("unknown MAGNUM_CPU_DISPATCH value mmx", result.stderr)
+
 class ImageView(unittest.TestCase):
     def test_init(self):
         # 2x4 RGB pixels, padded for alignment
@@ -262,3 +289,237 @@ class ImageView(unittest.TestCase):
         self.assertIs(a.owner, data2)
         self.assertEqual(sys.getrefcount(data), data_refcount)
         self.assertEqual(sys.getrefcount(data2), data2_refcount + 1)
+
+class ResourceManager_(unittest.TestCase):
+    def test(self):
+        manager = ResourceManager()
+        self.assertEqual(manager.count, 0)
+        self.assertEqual(manager.state('data'), ResourceState.NOT_LOADED)
+
+        data = [1, 2, 3]
+        data_refcount = sys.getrefcount(data)
+        manager.set('data', data, ResourceDataState.MUTABLE)
+        self.assertEqual(manager.count, 1)
+        self.assertEqual(manager.state('data'), ResourceState.MUTABLE)
+        self.assertEqual(sys.getrefcount(data), data_refcount + 1)
+
+        resource = manager.get('data')
+        self.assertEqual(resource.key, 'data')
+        self.assertEqual(resource.state, ResourceState.MUTABLE)
+        self.assertTrue(resource)
+        self.assertIs(resource.data, data)
+        self.assertEqual(manager.reference_count('data'), 1)
+
+        # Changing the data is reflected in the existing reference
+        data2 = [4, 5]
+        manager.set('data', data2)
+        self.assertIs(resource.data, data2)
+        self.assertEqual(resource.state, ResourceState.FINAL)
+        self.assertEqual(sys.getrefcount(data), data_refcount)
+
+        del resource
+        self.assertEqual(manager.reference_count('data'), 0)
+
+    def test_fallback(self):
+        manager = ResourceManager()
+        self.assertIsNone(manager.fallback)
+
+        resource = manager.get('nonexistent')
+        self.assertFalse(resource)
+        self.assertIsNone(resource.data)
+
+        fallback = 'fallback'
+        manager.fallback = fallback
+        self.assertIs(manager.fallback, fallback)
+        self.assertEqual(resource.state, ResourceState.NOT_LOADED_FALLBACK)
+        self.assertTrue(resource)
+        self.assertIs(resource.data, fallback)
+
+        manager.set('nonexistent', None, ResourceDataState.NOT_FOUND)
+        self.assertEqual(resource.state, ResourceState.NOT_FOUND_FALLBACK)
+
+    def test_policy(self):
+        manager = ResourceManager()
+        manager.set('resident', 1, policy=ResourcePolicy.RESIDENT)
+        manager.set('manual', 2, policy=ResourcePolicy.MANUAL)
+        manager.set('counted', 3, policy=ResourcePolicy.REFERENCE_COUNTED)
+        self.assertEqual(manager.count, 3)
+
+        # Reference-counted resource is deleted on last reference removal
+        counted = manager.get('counted')
+        del counted
+        self.assertEqual(manager.state('counted'), ResourceState.NOT_LOADED)
+        self.assertEqual(manager.count, 2)
+
+        # Manual resources are freed only if not referenced
+        manual = manager.get('manual')
+        manager.free()
+        self.assertEqual(manager.state('manual'), ResourceState.FINAL)
+        del manual
+        manager.free()
+        self.assertEqual(manager.state('manual'), ResourceState.NOT_LOADED)
+        self.assertEqual(manager.state('resident'), ResourceState.FINAL)
+
+        resident = manager.get('resident')
+        with self.assertRaisesRegex(RuntimeError, "resource resident is still referenced"):
+            manager.clear()
+        del resident
+        manager.clear()
+        self.assertEqual(manager.count, 0)
+
+    def test_set_invalid(self):
+        manager = ResourceManager()
+        with self.assertRaisesRegex(ValueError, "data should be None if and only if state is NOT_FOUND or LOADING"):
+            manager.set('data', None)
+        with self.assertRaisesRegex(ValueError, "data should be None if and only if state is NOT_FOUND or LOADING"):
+            manager.set('data', 1, ResourceDataState.LOADING)
+
+        manager.set('data', 1)
+        with self.assertRaisesRegex(RuntimeError, "cannot change an already final resource"):
+            manager.set('data', 2)
+
+    def test_loader(self):
+        class Loader(AbstractResourceLoader):
+            def __init__(self):
+                AbstractResourceLoader.__init__(self)
+                self.pending = []
+
+            def do_load(self, key):
+                if key == 'sync':
+                    self.set(key, 'loaded ' + key)
+                elif key == 'async':
+                    self.set(key, None, ResourceDataState.LOADING)
+                    self.pending += [key]
+                else:
+                    self.set_not_found(key)
+
+            def finish(self):
+                for key in self.pending:
+                    self.set(key, 'loaded ' + key)
+                self.pending = []
+
+        loader = Loader()
+        with self.assertRaisesRegex(RuntimeError, "the loader is not set for any manager"):
+            loader.set('sync', 1)
+
+        manager = ResourceManager()
+        manager.loader = loader
+        self.assertIs(manager.loader, loader)
+
+        sync = manager.get('sync')
+        self.assertEqual(sync.state, ResourceState.FINAL)
+        self.assertEqual(sync.data, 'loaded sync')
+
+        not_found = manager.get('nonexistent')
+        self.assertEqual(not_found.state, ResourceState.NOT_FOUND)
+
+        async_ = manager.get('async')
+        self.assertEqual(async_.state, ResourceState.LOADING)
+        self.assertIsNone(async_.data)
+        loader.finish()
+        self.assertEqual(async_.state, ResourceState.FINAL)
+        self.assertEqual(async_.data, 'loaded async')
+
+        self.assertEqual(loader.requested_count, 3)
+        self.assertEqual(loader.loaded_count, 2)
+        self.assertEqual(loader.not_found_count, 1)
+
+        # The loader can't be used for two managers at the same time
+        with self.assertRaisesRegex(RuntimeError, "the loader is already set for a manager"):
+            ResourceManager().loader = loader
+
+        manager.loader = None
+        self.assertIsNone(manager.loader)
+        self.assertEqual(loader.requested_count, 0)
+
+class ThreadPool(unittest.TestCase):
+    def tearDown(self):
+        magnum.set_thread_count()
+        magnum.set_grain_size(1024)
+
+    def test_thread_count(self):
+        magnum.set_thread_count(3)
+        self.assertEqual(magnum.thread_count(), 3)
+
+        magnum.set_thread_count(1)
+        self.assertEqual(magnum.thread_count(), 1)
+
+        # Zero means hardware concurrency
+        magnum.set_thread_count(0)
+        self.assertGreaterEqual(magnum.thread_count(), 1)
+
+    def test_grain_size(self):
+        self.assertEqual(magnum.grain_size(), 1024)
+        magnum.set_grain_size(16)
+        self.assertEqual(magnum.grain_size(), 16)
+
+        with self.assertRaisesRegex(ValueError, "grain size can't be zero"):
+            magnum.set_grain_size(0)
+
+    def test_stats(self):
+        magnum.set_thread_count(2)
+        magnum.reset_thread_pool_stats()
+        stats = magnum.thread_pool_stats()
+        self.assertEqual(stats['thread_count'], 2)
+        self.assertEqual(stats['regions'], 0)
+        self.assertEqual(stats['serial_regions'], 0)
+        self.assertEqual(stats['nested_regions'], 0)
+        self.assertEqual(stats['tasks'], 0)
+        self.assertEqual(stats['steals'], 0)
+        self.assertEqual(stats['queue_depth'], 0)
+        self.assertEqual(stats['max_queue_depth'], 0)
+        self.assertEqual(stats['busy_time'], 0.0)
+        self.assertEqual(stats['utilization'], 0.0)
+
+class Tracing(unittest.TestCase):
+    def setUp(self):
+        magnum.clear_trace()
+
+    def tearDown(self):
+        magnum.set_tracing(False)
+        magnum.clear_trace()
+
+    def test(self):
+        self.assertFalse(magnum.is_tracing())
+
+        # Nothing recorded when disabled
+        with TraceZone('disabled'):
+            pass
+        self.assertEqual(magnum.trace_events(), [])
+
+        magnum.set_tracing(True)
+        self.assertTrue(magnum.is_tracing())
+        with TraceZone('outer'):
+            with TraceZone('inner', category='physics'):
+                pass
+
+        events = magnum.trace_events()
+        self.assertEqual([(e['name'], e['category']) for e in events],
+            [('inner', 'physics'), ('outer', 'python')])
+        self.assertGreaterEqual(events[1]['duration'], events[0]['duration'])
+
+        magnum.clear_trace()
+        self.assertEqual(magnum.trace_events(), [])
+
+    def test_save(self):
+        magnum.set_tracing(True)
+        with TraceZone('a "quoted" zone'):
+            pass
+
+        with tempfile.TemporaryDirectory() as tmp:
+            filename = os.path.join(tmp, 'trace.json')
+            magnum.save_trace(filename)
+            with open(filename) as f:
+                trace = json.load(f)
+
+        self.assertEqual(len(trace['traceEvents']), 1)
+        event = trace['traceEvents'][0]
+        self.assertEqual(event['name'], 'a "quoted" zone')
+        self.assertEqual(event['cat'], 'python')
+        self.assertEqual(event['ph'], 'X')
+        self.assertEqual(event['ts'], 0.0)
+        self.assertEqual(event['tid'], 0)
+
+    def test_save_failed(self):
+        with self.assertRaisesRegex(RuntimeError, "cannot open /nonexistent/trace.json for writing"):
+            magnum.save_trace('/nonexistent/trace.json')
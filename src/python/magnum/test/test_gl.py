@@ -35,6 +35,8 @@ class Attribute(unittest.TestCase):
         self.assertEqual(a.location, 2)
         self.assertEqual(a.components, gl.Attribute.Components.TWO)
         self.assertEqual(a.data_type, gl.Attribute.DataType.FLOAT)
+        self.assertEqual(a.vectors, 1)
+        self.assertEqual(a.vector_stride, 8)
 
 class FramebufferClear(unittest.TestCase):
     def test_ops(self):
@@ -24,16 +24,18 @@
 #
 
 import array
+import asyncio
 import sys
+import threading
 import unittest
 
 # setUpModule gets called before everything else, skipping if GL tests can't
 # be run
-from . import GLTestCase, setUpModule
+from . import GLTestCase, allocations_per_call, setUpModule
 
 import magnum
 from magnum import *
-from magnum import gl
+from magnum import gl, shaders
 
 class AbstractShaderProgram(GLTestCase):
     def test(self):
@@ -132,6 +134,99 @@ class Buffer(GLTestCase):
         a = gl.Buffer()
         a.set_data(array.array('f', [0.5, 1.2]))
 
+    def test_set_sub_data(self):
+        a = gl.Buffer()
+        a.set_data(b'hello', gl.BufferUsage.DYNAMIC_DRAW)
+        a.set_sub_data(1, b'ipp')
+
+    def test_set_data_allocations(self):
+        a = gl.Buffer()
+        data = array.array('f', [0.5]*256)
+        # The data is passed through the buffer protocol, so the only Python
+        # allocation should be the temporary bound method object
+        self.assertLessEqual(allocations_per_call(lambda: a.set_sub_data(0, data)), 1)
+        self.assertLessEqual(allocations_per_call(lambda: a.set_data(data, gl.BufferUsage.DYNAMIC_DRAW)), 1)
+
+    def test_bind(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("indexed buffer binding not available in ES2")
+
+        a = gl.Buffer()
+        a.set_data(array.array('f', [0.0]*64))
+        a.bind(gl.Buffer.Target.UNIFORM, 0)
+        a.bind(gl.Buffer.Target.UNIFORM, 1, 0, 64)
+
+class DeferredDeletion(GLTestCase):
+    def tearDown(self):
+        gl.set_deferred_deletion(False)
+        super().tearDown()
+
+    def test(self):
+        gl.delete_deferred_objects()
+        self.assertEqual(gl.deferred_object_count(), 0)
+
+        gl.set_deferred_deletion(True)
+        a = gl.Buffer()
+        b = gl.Texture2D()
+        c = gl.Renderbuffer()
+        del a, b, c
+        self.assertEqual(gl.deferred_object_count(), 3)
+
+        gl.set_deferred_deletion(False)
+        a = gl.Buffer()
+        del a
+        self.assertEqual(gl.deferred_object_count(), 3)
+
+        self.assertEqual(gl.delete_deferred_objects(), 3)
+        self.assertEqual(gl.deferred_object_count(), 0)
+        self.assertEqual(gl.delete_deferred_objects(), 0)
+
+    def test_other_thread(self):
+        gl.delete_deferred_objects()
+
+        # Dropping the last reference on a different thread defers the
+        # deletion even if not enabled explicitly
+        objects = [gl.Buffer(), gl.Texture2D()]
+        thread = threading.Thread(target=objects.clear)
+        thread.start()
+        thread.join()
+        self.assertEqual(gl.deferred_object_count(), 2)
+        self.assertEqual(gl.delete_deferred_objects(), 2)
+
+class MemoryAccounting(GLTestCase):
+    def test(self):
+        # Other tests may leave objects alive, so compare only differences
+        before = gl.memory_usage()
+
+        buffer = gl.Buffer()
+        buffer.set_data(b'hello')
+        texture = gl.Texture2D()
+        texture.set_storage(levels=3, internal_format=gl.TextureFormat.RGBA8,
+                            size=Vector2i(4))
+        renderbuffer = gl.Renderbuffer()
+        renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
+        mesh = gl.Mesh()
+
+        after = gl.memory_usage()
+        for type, count, bytes in [('buffer', 1, 5),
+                                   ('texture', 1, 64 + 16 + 4),
+                                   ('renderbuffer', 1, 64),
+                                   ('mesh', 1, 0)]:
+            self.assertEqual(after[type]['count'], before[type]['count'] + count)
+            self.assertEqual(after[type]['bytes'], before[type]['bytes'] + bytes)
+
+        # Respecifying the data replaces the previous size
+        buffer.set_data(b'hi')
+        self.assertEqual(gl.memory_usage()['buffer']['bytes'], before['buffer']['bytes'] + 2)
+
+        objects = {(o['type'], o['id']): o['bytes'] for o in gl.memory_objects()}
+        self.assertEqual(objects[('buffer', buffer.id)], 2)
+        self.assertEqual(objects[('texture', texture.id)], 84)
+        self.assertEqual(objects[('renderbuffer', renderbuffer.id)], 64)
+
+        del buffer, texture, renderbuffer, mesh
+        self.assertEqual(gl.memory_usage(), before)
+
 class DefaultFramebuffer(GLTestCase):
     def test(self):
         # Using it should not crash, leak or cause double-free issues
@@ -206,6 +301,32 @@ class Framebuffer(GLTestCase):
         del mview
         self.assertEqual(sys.getrefcount(a), a_refcount)
 
+    @unittest.skipIf(magnum.TARGET_GLES2 or magnum.TARGET_WEBGL, "buffer images not available on ES2 and WebGL")
+    def test_read_async(self):
+        renderbuffer = gl.Renderbuffer()
+        renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
+
+        framebuffer = gl.Framebuffer(((0, 0), (4, 4)))
+        framebuffer.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), renderbuffer)
+
+        gl.Renderer.clear_color = Color4(1.0, 0.5, 0.75)
+        framebuffer.clear(gl.FramebufferClear.COLOR)
+
+        async def read():
+            return await framebuffer.read_async(Range2Di.from_size((1, 1), (2, 2)), PixelFormat.RGBA8_UNORM)
+
+        loop = asyncio.new_event_loop()
+        try:
+            a = loop.run_until_complete(read())
+        finally:
+            loop.close()
+
+        self.assertEqual(a.size, Vector2i(2, 2))
+        self.assertEqual(a.format, PixelFormat.RGBA8_UNORM)
+        self.assertEqual(ord(a.pixels[0, 0, 0]), 0xff)
+        self.assertEqual(ord(a.pixels[0, 1, 1]), 0x80)
+        self.assertEqual(ord(a.pixels[1, 0, 2]), 0xbf)
+
     def test_read_view(self):
         renderbuffer = gl.Renderbuffer()
         renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
@@ -255,6 +376,12 @@ class Mesh(GLTestCase):
         a.count = 15
         self.assertEqual(a.count, 15)
 
+    def test_set_instance_count(self):
+        a = gl.Mesh()
+        self.assertEqual(a.instance_count, 1)
+        a.instance_count = 150
+        self.assertEqual(a.instance_count, 150)
+
     def test_add_buffer(self):
         buffer = gl.Buffer()
         buffer_refcount = sys.getrefcount(buffer)
@@ -270,6 +397,54 @@ class Mesh(GLTestCase):
         del mesh
         self.assertEqual(sys.getrefcount(buffer), buffer_refcount)
 
+    def test_add_buffer_instanced(self):
+        buffer = gl.Buffer()
+        buffer_refcount = sys.getrefcount(buffer)
+
+        # Same reference counting as with non-instanced buffers
+        mesh = gl.Mesh()
+        mesh.add_vertex_buffer_instanced(buffer, 1, 0, 16, gl.Attribute(gl.Attribute.Kind.GENERIC, 3, gl.Attribute.Components.FOUR, gl.Attribute.DataType.FLOAT))
+        self.assertEqual(len(mesh.buffers), 1)
+        self.assertIs(mesh.buffers[0], buffer)
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount + 1)
+
+        del mesh
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount)
+
+class MeshView(GLTestCase):
+    def test_init(self):
+        mesh = gl.Mesh()
+        mesh_refcount = sys.getrefcount(mesh)
+
+        # Creating a view should increase mesh ref count
+        view = gl.MeshView(mesh)
+        self.assertIs(view.mesh, mesh)
+        self.assertEqual(sys.getrefcount(mesh), mesh_refcount + 1)
+
+        view.count = 3
+        view.base_vertex = 5
+        view.instance_count = 2
+        view.set_index_range(3)
+        self.assertEqual(view.count, 3)
+        self.assertEqual(view.base_vertex, 5)
+        self.assertEqual(view.instance_count, 2)
+
+        # Deleting the view should decrease it again
+        del view
+        self.assertEqual(sys.getrefcount(mesh), mesh_refcount)
+
+    def test_draw(self):
+        mesh = gl.Mesh()
+        a = gl.MeshView(mesh)
+        b = gl.MeshView(mesh)
+        shaders.Flat3D().draw([a, b])
+
+    def test_draw_different_meshes(self):
+        a = gl.MeshView(gl.Mesh())
+        b = gl.MeshView(gl.Mesh())
+        with self.assertRaisesRegex(ValueError, "all mesh views have to be from the same mesh"):
+            shaders.Flat3D().draw([a, b])
+
 class Renderbuffer(GLTestCase):
     def test_init(self):
         renderbuffer = gl.Renderbuffer()
@@ -311,6 +486,10 @@ class Shader(GLTestCase):
         with self.assertRaisesRegex(RuntimeError, "compilation failed"):
             a.compile()
 
+    def test_add_source_allocations(self):
+        a = gl.Shader(gl.Version.NONE, gl.Shader.Type.VERTEX)
+        self.assertLessEqual(allocations_per_call(lambda: a.add_source("// comment\n")), 2)
+
 class AbstractTexture(GLTestCase):
     def test_unbind(self):
         gl.AbstractTexture.unbind(3)
@@ -419,3 +598,80 @@ class Texture(GLTestCase):
             # This is in ES3.2 too, but we don't have a way to check for
             # extensions / version yet
             self.assertEqual(a.image_size(0), Vector2i(16, 16))
+
+class TextureStreamer(GLTestCase):
+    def levels(self):
+        return [ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(4), b'\xff'*64),
+                ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(2), b'\xff'*16),
+                ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(1), b'\xff'*4)]
+
+    def test(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("not available on ES2")
+
+        a = gl.TextureStreamer(budget=88)
+        self.assertEqual(a.budget, 88)
+
+        # The coarsest level gets uploaded right away
+        first = a.add(self.levels(), gl.TextureFormat.RGBA8)
+        second = a.add(self.levels(), gl.TextureFormat.RGBA8)
+        self.assertEqual(len(a), 2)
+        self.assertIsInstance(a.texture(first), gl.Texture2D)
+        self.assertEqual(a.resident_level(first), 2)
+        self.assertEqual(a.resident_bytes, 8)
+        self.assertIsNone(a.last_used(first))
+
+        # Only used textures get more levels, at most one per frame and within
+        # the upload budget
+        a.use(first)
+        self.assertEqual(a.update(upload_budget=1024), 16)
+        self.assertEqual(a.frame, 1)
+        self.assertEqual(a.resident_level(first), 1)
+        self.assertEqual(a.resident_level(second), 2)
+        self.assertEqual(a.last_used(first), 0)
+        a.use(first)
+        a.use(second)
+        self.assertEqual(a.update(upload_budget=32), 16)
+        self.assertEqual(a.resident_level(first), 1)
+        self.assertEqual(a.resident_level(second), 1)
+        self.assertEqual(a.resident_bytes, 40)
+
+        # The full level doesn't fit into the budget unless the other texture
+        # is evicted
+        a.use(first)
+        a.use(second)
+        self.assertEqual(a.update(upload_budget=1024), 0)
+        self.assertEqual(a.resident_level(first), 1)
+
+        texture = a.texture(second)
+        a.use(first)
+        self.assertEqual(a.update(upload_budget=1024), 64)
+        self.assertEqual(a.resident_level(first), 0)
+        self.assertEqual(a.resident_level(second), 2)
+        self.assertEqual(a.resident_bytes, 4 + 16 + 64 + 4)
+        self.assertEqual(a.uploaded_bytes, 4 + 4 + 16 + 16 + 64)
+        self.assertEqual(a.evicted_bytes, 16)
+
+        # The texture object stays the same after eviction
+        self.assertIs(a.texture(second), texture)
+
+        # Lowering the budget evicts everything except the coarsest levels
+        a.budget = 0
+        a.update(upload_budget=0)
+        self.assertEqual(a.resident_bytes, 8)
+
+    def test_invalid(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("not available on ES2")
+
+        a = gl.TextureStreamer(budget=1024)
+        with self.assertRaisesRegex(ValueError, "expected at least one level"):
+            a.add([], gl.TextureFormat.RGBA8)
+        with self.assertRaisesRegex(ValueError, r"expected level 1 to have size \{2, 2\} but got \{1, 1\}"):
+            a.add([ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(4), b'\xff'*64),
+                   ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(1), b'\xff'*4)], gl.TextureFormat.RGBA8)
+        with self.assertRaisesRegex(ValueError, "expected level 1 to have the same format as level 0"):
+            a.add([ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(2), b'\xff'*16),
+                   ImageView2D(PixelFormat.R32F, Vector2i(1), b'\xff'*4)], gl.TextureFormat.RGBA8)
+        with self.assertRaisesRegex(IndexError, "index 0 out of range for 0 textures"):
+            a.texture(0)
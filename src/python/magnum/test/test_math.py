@@ -29,6 +29,8 @@ import unittest
 from magnum import *
 from magnum import math
 
+from . import AllocationCounter, allocations_per_call
+
 class Angle(unittest.TestCase):
     def test_init(self):
         a = Deg()
@@ -117,6 +119,80 @@ class Functions(unittest.TestCase):
         self.assertAlmostEqual(sincos[0], 1.0)
         self.assertAlmostEqual(sincos[1], 0.0)
 
+class FunctionsArray(unittest.TestCase):
+    def test_sin_cos_tan(self):
+        a = DegArray(array.array('f', [0.0, 30.0, 90.0, 180.0, 225.0]))
+        sin = array.array('f', [0.0]*5)
+        cos = array.array('f', [0.0]*5)
+        tan = array.array('f', [0.0]*5)
+        math.sin(a, sin)
+        math.cos(a, cos)
+        math.tan(a, tan)
+        for i, expected in enumerate([0.0, 0.5, 1.0, 0.0, -0.7071068]):
+            self.assertAlmostEqual(sin[i], expected, 6)
+        for i, expected in enumerate([1.0, 0.8660254, 0.0, -1.0, -0.7071068]):
+            self.assertAlmostEqual(cos[i], expected, 6)
+        self.assertAlmostEqual(tan[1], 0.5773503, 6)
+        self.assertAlmostEqual(tan[4], 1.0, 6)
+
+    def test_sincos(self):
+        a = array.array('d', [0.0, math.pi_half])
+        sin = array.array('d', [0.0]*2)
+        math.sincos(RadArray(a), sin, a)
+        self.assertEqual(list(sin), [0.0, 1.0])
+        self.assertAlmostEqual(a[0], 1.0)
+        self.assertAlmostEqual(a[1], 0.0)
+
+    def test_in_place(self):
+        a = array.array('f', [0.0, 30.0, 90.0])
+        math.sin(DegArray(a))
+        self.assertAlmostEqual(a[1], 0.5, 6)
+        self.assertAlmostEqual(a[2], 1.0, 6)
+
+    def test_inverse(self):
+        a = array.array('f', [1.0, 0.5, -1.0, 2.0])
+        deg = array.array('f', [0.0]*4)
+        math.asin(a, DegArray(deg))
+        self.assertAlmostEqual(deg[0], 90.0, 4)
+        self.assertAlmostEqual(deg[1], 30.0, 4)
+        self.assertAlmostEqual(deg[2], -90.0, 4)
+        self.assertNotEqual(deg[3], deg[3]) # NaN
+
+        rad = array.array('d', [0.0]*4)
+        math.acos(array.array('d', [1.0, 0.5, -1.0, 0.0]), RadArray(rad))
+        self.assertEqual(rad[0], 0.0)
+        self.assertAlmostEqual(rad[1], math.pi/3)
+        self.assertAlmostEqual(rad[2], math.pi)
+        self.assertAlmostEqual(rad[3], math.pi_half)
+
+        math.atan(a, DegArray(a))
+        self.assertAlmostEqual(a[0], 45.0, 4)
+
+    def test_many(self):
+        # Enough items to go through the vector kernels and several threads,
+        # with a few left over at the end
+        a = array.array('f', [i*0.01 - 50.0 for i in range(10003)])
+        sin = array.array('f', [0.0]*len(a))
+        math.sin(RadArray(a), sin)
+        for i in range(len(a)):
+            self.assertAlmostEqual(sin[i], math.sin(Rad(a[i])), 6)
+
+    def test_unit(self):
+        a = DegArray(array.array('f', [0.0]))
+        self.assertIsInstance(a.data, array.array)
+        with self.assertRaises(TypeError):
+            math.sin(array.array('f', [0.0]))
+        with self.assertRaises(TypeError):
+            math.asin(array.array('f', [0.0]), array.array('f', [0.0]))
+
+    def test_invalid(self):
+        with self.assertRaisesRegex(BufferError, "expected a float or double format but got i"):
+            DegArray(array.array('i', [0]))
+        with self.assertRaisesRegex(BufferError, "expected an output format of f but got d"):
+            math.sin(RadArray(array.array('f', [0.0])), array.array('d', [0.0]))
+        with self.assertRaisesRegex(ValueError, "expected 2 output items but got 3"):
+            math.sin(RadArray(array.array('f', [0.0]*2)), array.array('f', [0.0]*3))
+
 class Vector(unittest.TestCase):
     def test_init(self):
         a = Vector4i()
@@ -1060,3 +1136,70 @@ class Range(unittest.TestCase):
                       Range2D((0.3, 2.0), (0.4, 2.1)))
         self.assertEqual(a, Range2D((0.3, 0.7), (4.5, 5.7)))
         self.assertEqual(a.center(), Vector2(2.4, 3.2))
+
+class Algorithms(unittest.TestCase):
+    def test_svd(self):
+        a = Matrix3x3d((4.0, 1.0, 0.0), (1.0, 3.0, 1.0), (0.0, 1.0, 2.0))
+        u, w, v = math.svd(a)
+        self.assertIsInstance(w, Vector3d)
+        self.assertEqual(u@Matrix3x3d.from_diagonal(w)@v.transposed(), a)
+
+    def test_qr(self):
+        a = Matrix3x3d((4.0, 1.0, 0.0), (1.0, 3.0, 1.0), (0.0, 1.0, 2.0))
+        q, r = math.qr(a)
+        self.assertTrue(q.is_orthogonal())
+        self.assertEqual(q@r, a)
+        self.assertAlmostEqual(r[0][1], 0.0)
+        self.assertAlmostEqual(r[0][2], 0.0)
+        self.assertAlmostEqual(r[1][2], 0.0)
+
+    def test_gram_schmidt(self):
+        a = math.gram_schmidt_orthonormalize(Matrix2x2((3.0, 1.0), (2.0, 2.0)))
+        self.assertIsInstance(a, Matrix2x2)
+        self.assertTrue(a.is_orthogonal())
+        self.assertEqual(a[0], Vector2(3.0, 1.0).normalized())
+
+        b = math.gram_schmidt_orthogonalize(Matrix2x2((3.0, 1.0), (2.0, 2.0)))
+        self.assertAlmostEqual(math.dot(b[0], b[1]), 0.0)
+
+    def test_gauss_jordan(self):
+        a = Matrix3x3d((4.0, 1.0, 0.0), (1.0, 3.0, 1.0), (0.0, 1.0, 2.0))
+        self.assertEqual(math.gauss_jordan_inverted(a), a.inverted())
+
+        with self.assertRaisesRegex(ValueError, "the matrix is singular"):
+            math.gauss_jordan_inverted(Matrix3x3d((1.0, 2.0, 3.0), (2.0, 4.0, 6.0), (0.0, 1.0, 2.0)))
+
+class Allocations(unittest.TestCase):
+    # Budgets for calls in hot loops. Every result is a new Python object and
+    # calling a pybind11 method or operator creates a temporary bound method
+    # object, so two allocations is the least these can do.
+
+    def test_vector(self):
+        a = Vector3(1.0, 2.0, 3.0)
+        b = Vector3(4.0, 5.0, 6.0)
+        self.assertLessEqual(allocations_per_call(lambda: Vector3(1.0, 2.0, 3.0)), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a + b), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a*2.0), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a.normalized()), 2)
+        self.assertLessEqual(allocations_per_call(lambda: math.dot(a, b)), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a.x), 2)
+
+    def test_matrix(self):
+        a = Matrix4.translation((1.0, 2.0, 3.0))
+        b = Matrix4.rotation_x(Deg(35.0))
+        v = Vector3.x_axis()
+        self.assertLessEqual(allocations_per_call(lambda: a@b), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a.inverted()), 2)
+        self.assertLessEqual(allocations_per_call(lambda: a.transform_point(v)), 2)
+
+    def test_no_leaks(self):
+        a = Vector3(1.0, 2.0, 3.0)
+        b = Matrix4.rotation_x(Deg(35.0))
+        # Warm up so no cache or free list gets populated while counting
+        for i in range(10):
+            b.transform_vector(a + a)
+        with AllocationCounter() as counter:
+            for i in range(10):
+                b.transform_vector(a + a)
+        self.assertLessEqual(counter.allocations + counter.objects, counter.deallocations)
+
@@ -342,3 +342,80 @@ class Matrix4_(unittest.TestCase):
              [5.0, 6.0, 7.0, 8.0],
              [9.0, 10.0, 11.0, 12.0],
              [13.0, 14.0, 15.0, 16.0]]))
+
+class Kabsch(unittest.TestCase):
+    def test(self):
+        rotation = np.array(Quaterniond.rotation(Deg(35.0), Vector3d(1.0, 2.0, 2.0).normalized()).to_matrix())
+        source = np.random.RandomState(0).standard_normal((20, 3))
+        target = source@rotation.T
+
+        # Second covariance is a scaled one, which should give the same result
+        covariance = source.T@target
+        covariances = np.stack([covariance, covariance*0.5])
+        out = np.empty_like(covariances)
+        math.kabsch(covariances, out)
+        np.testing.assert_allclose(out[0], rotation, atol=1.0e-9)
+        np.testing.assert_allclose(out[1], rotation, atol=1.0e-9)
+
+    def test_zero(self):
+        out = np.empty((1, 3, 3), dtype='f')
+        math.kabsch(np.zeros((1, 3, 3), dtype='f'), out)
+        np.testing.assert_array_equal(out[0], np.identity(3))
+
+    def test_orthonormalize(self):
+        rotation = np.array(Quaterniond.rotation(Deg(35.0), Vector3d(1.0, 2.0, 2.0).normalized()).to_matrix())
+        noisy = rotation + 0.01*np.random.RandomState(0).standard_normal((3, 3))
+        out = np.empty((1, 3, 3))
+        math.orthonormalize(noisy[np.newaxis], out)
+        np.testing.assert_allclose(out[0]@out[0].T, np.identity(3), atol=1.0e-9)
+        self.assertAlmostEqual(np.linalg.det(out[0]), 1.0)
+        np.testing.assert_allclose(out[0], rotation, atol=0.05)
+
+    def test_orthonormalize_in_place(self):
+        rotation = np.array(Quaterniond.rotation(Deg(35.0), Vector3d(1.0, 2.0, 2.0).normalized()).to_matrix())
+        a = np.array([rotation*2.0, rotation], dtype='f')
+        math.orthonormalize(a, a)
+        np.testing.assert_allclose(a[0], rotation, atol=1.0e-6)
+        np.testing.assert_allclose(a[1], rotation, atol=1.0e-6)
+
+    def test_invalid(self):
+        with self.assertRaisesRegex(BufferError, "expected 3 dimensions but got 2"):
+            math.kabsch(np.zeros((3, 3)), np.zeros((3, 3)))
+        with self.assertRaisesRegex(BufferError, "expected a shape of \\(n, 3, 3\\) but got \\(2, 4, 4\\)"):
+            math.kabsch(np.zeros((2, 4, 4)), np.zeros((2, 4, 4)))
+        with self.assertRaisesRegex(BufferError, "expected a float or double format but got i"):
+            math.kabsch(np.zeros((2, 3, 3), dtype='i'), np.zeros((2, 3, 3)))
+        with self.assertRaisesRegex(ValueError, "expected 2 output matrices but got 3"):
+            math.kabsch(np.zeros((2, 3, 3)), np.zeros((3, 3, 3)))
+
+class CameraRelative(unittest.TestCase):
+    def test(self):
+        # Too far from the origin for the fractional part to survive a
+        # conversion to floats
+        transformations = np.array([
+            Matrix4d.translation((1.0e7 + 0.125, 2.0e7, 3.0))@Matrix4d.rotation_z(Deg(90.0)),
+            Matrix4d.translation((1.0e7, 2.0e7 - 0.25, 0.0))])
+        out = np.empty(transformations.shape, dtype='f')
+        math.camera_relative(transformations, Matrix4d.translation((-1.0e7, -2.0e7, 0.0)), out)
+        np.testing.assert_allclose(out[0], np.array(Matrix4.translation((0.125, 0.0, 3.0))@Matrix4.rotation_z(Deg(90.0))), atol=1.0e-6)
+        np.testing.assert_allclose(out[1], np.array(Matrix4.translation((0.0, -0.25, 0.0))), atol=1.0e-6)
+
+    def test_strided(self):
+        transformations = np.array([
+            Matrix4d.translation((1.0e7 + 0.125, 2.0e7, 3.0)),
+            Matrix4d.scaling((2.0, 3.0, 4.0))])
+        # Every other matrix of a column-major output
+        out = np.empty((4, 4, 4), dtype='f').transpose(0, 2, 1)[::2]
+        math.camera_relative(transformations.transpose(0, 2, 1).copy().transpose(0, 2, 1), Matrix4d.translation((-1.0e7, -2.0e7, 0.0)), out)
+        np.testing.assert_allclose(out[0], np.array(Matrix4.translation((0.125, 0.0, 3.0))), atol=1.0e-6)
+        np.testing.assert_allclose(out[1], np.array(Matrix4.translation((-1.0e7, -2.0e7, 0.0))@Matrix4.scaling((2.0, 3.0, 4.0))))
+
+    def test_invalid(self):
+        with self.assertRaisesRegex(BufferError, "expected a shape of \\(n, 4, 4\\) but got \\(2, 3, 3\\)"):
+            math.camera_relative(np.zeros((2, 3, 3)), Matrix4d(), np.zeros((2, 3, 3), dtype='f'))
+        with self.assertRaisesRegex(BufferError, "expected a double format but got f"):
+            math.camera_relative(np.zeros((2, 4, 4), dtype='f'), Matrix4d(), np.zeros((2, 4, 4), dtype='f'))
+        with self.assertRaisesRegex(BufferError, "expected a float format but got d"):
+            math.camera_relative(np.zeros((2, 4, 4)), Matrix4d(), np.zeros((2, 4, 4)))
+        with self.assertRaisesRegex(ValueError, "expected 2 output matrices but got 3"):
+            math.camera_relative(np.zeros((2, 4, 4)), Matrix4d(), np.zeros((3, 4, 4), dtype='f'))
@@ -23,6 +23,7 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import array
 import unittest
 
 # setUpModule gets called before everything else, skipping if GL tests can't
@@ -30,7 +31,7 @@ import unittest
 from . import GLTestCase, setUpModule
 
 from magnum import *
-from magnum import gl, meshtools, primitives
+from magnum import gl, meshtools, primitives, trade
 
 class Compile(GLTestCase):
     def test_2d(self):
@@ -42,3 +43,11 @@ class Compile(GLTestCase):
         a = meshtools.compile(primitives.cube_solid())
         self.assertEqual(a.primitive, gl.MeshPrimitive.TRIANGLES)
         self.assertEqual(a.count, 36)
+
+    def test_external_data(self):
+        positions = memoryview(array.array('f', [0.0, 0.0, 1.0, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[3, 2])
+        a = meshtools.compile(trade.MeshData(MeshPrimitive.TRIANGLES, array.array('B', [0, 1, 2]), {
+            trade.MeshAttribute.POSITION: positions
+        }))
+        self.assertEqual(a.primitive, gl.MeshPrimitive.TRIANGLES)
+        self.assertEqual(a.count, 3)
@@ -0,0 +1,89 @@
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+import unittest
+
+# setUpModule gets called before everything else, skipping if GL tests can't
+# be run
+from . import GLTestCase, setUpModule
+
+import magnum
+from magnum import *
+from magnum import gl, primitives
+
+try:
+    from magnum.platform.glx import BackgroundUploader
+except ImportError:
+    try:
+        from magnum.platform.egl import BackgroundUploader
+    except ImportError:
+        BackgroundUploader = None
+
+class BackgroundUploader_(GLTestCase):
+    def setUp(self):
+        super().setUp()
+        if not BackgroundUploader:
+            self.skipTest("background uploader not available")
+
+    def test_texture(self):
+        uploader = BackgroundUploader()
+
+        data = b'\xff'*4*16*16
+        future = uploader.upload_texture(
+            ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(16), data),
+            gl.TextureFormat.RGBA8, generate_mipmap=True)
+        self.assertEqual(uploader.pending_count, 1)
+
+        uploader.finish()
+        self.assertEqual(uploader.pending_count, 0)
+        self.assertTrue(future.done())
+
+        texture = future.result()
+        self.assertIsInstance(texture, gl.Texture2D)
+        if not magnum.TARGET_GLES:
+            self.assertEqual(texture.image_size(4), Vector2i(1, 1))
+
+    def test_mesh(self):
+        uploader = BackgroundUploader()
+        if not hasattr(uploader, 'upload_mesh'):
+            self.skipTest("mesh upload not available")
+
+        cube = primitives.cube_solid()
+        indexed = uploader.upload_mesh(cube)
+        nonindexed = uploader.upload_mesh(primitives.plane_solid())
+
+        # Nothing is resolved until polled
+        while uploader.pending_count:
+            uploader.poll()
+        self.assertEqual(indexed.result().count, 36)
+        self.assertEqual(nonindexed.result().count, 4)
+
+    def test_destroy_with_pending(self):
+        uploader = BackgroundUploader()
+        future = uploader.upload_texture(
+            ImageView2D(PixelFormat.RGBA8_UNORM, Vector2i(4), b'\xff'*64),
+            gl.TextureFormat.RGBA8)
+        del uploader
+        self.assertFalse(future.done())
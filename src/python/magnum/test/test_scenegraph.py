@@ -26,6 +26,7 @@
 import sys
 import unittest
 
+import magnum
 from magnum import *
 from magnum import scenegraph
 from magnum.scenegraph.matrix import Object3D, Scene3D
@@ -243,6 +244,44 @@ class Object(unittest.TestCase):
         self.assertIsNone(camera.object)
         self.assertIs(len(drawables), 0)
 
+    def test_camera_draw_trampoline_stats(self):
+        scene = Scene3D()
+        drawables = scenegraph.DrawableGroup3D()
+        camera = scenegraph.Camera3D(Object3D(scene))
+
+        class MyDrawable(scenegraph.Drawable3D):
+            def draw(self, transformation_matrix: Matrix4, camera: scenegraph.Camera3D):
+                pass
+
+        class MyOtherDrawable(scenegraph.Drawable3D):
+            def draw(self, transformation_matrix: Matrix4, camera: scenegraph.Camera3D):
+                pass
+
+        a = MyDrawable(Object3D(scene), drawables)
+        b = MyDrawable(Object3D(scene), drawables)
+        c = MyOtherDrawable(Object3D(scene), drawables)
+
+        # Nothing counted when disabled
+        magnum.reset_trampoline_stats()
+        camera.draw(drawables)
+        self.assertEqual(magnum.trampoline_stats(), {})
+
+        magnum.set_trampoline_counters(True)
+        try:
+            camera.draw(drawables)
+            camera.draw(drawables)
+        finally:
+            magnum.set_trampoline_counters(False)
+
+        stats = magnum.trampoline_stats()
+        self.assertEqual(set(stats.keys()), {'MyDrawable.draw', 'MyOtherDrawable.draw'})
+        self.assertEqual(stats['MyDrawable.draw']['calls'], 4)
+        self.assertEqual(stats['MyOtherDrawable.draw']['calls'], 2)
+        self.assertGreater(stats['MyDrawable.draw']['time'], 0.0)
+
+        magnum.reset_trampoline_stats()
+        self.assertEqual(magnum.trampoline_stats(), {})
+
 class Feature(unittest.TestCase):
     def test(self):
         class MyFeature(scenegraph.AbstractFeature3D):
@@ -23,12 +23,14 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import array
 import unittest
 
 # setUpModule gets called before everything else, skipping if GL tests can't
 # be run
 from . import GLTestCase, setUpModule
 
+import magnum
 from magnum import *
 from magnum import gl, shaders
 
@@ -58,6 +60,101 @@ class Flat(GLTestCase):
         texture = gl.Texture2D()
         with self.assertRaisesRegex(AttributeError, "the shader was not created with texturing enabled"):
             a.bind_texture(texture)
+        with self.assertRaisesRegex(AttributeError, "the shader was not created with texture transformation enabled"):
+            a.texture_matrix = Matrix3()
+
+    def test_instanced(self):
+        a = shaders.Flat3D(shaders.Flat3D.Flags.TEXTURED|shaders.Flat3D.Flags.INSTANCED_TRANSFORMATION|shaders.Flat3D.Flags.INSTANCED_TEXTURE_OFFSET)
+        # Instanced texture offset implies texture transformation
+        self.assertTrue(a.flags & shaders.Flat3D.Flags.TEXTURE_TRANSFORMATION)
+        a.texture_matrix = Matrix3.scaling(Vector2(0.5))
+
+        self.assertEqual(shaders.Flat2D.TRANSFORMATION_MATRIX.vectors, 3)
+        self.assertEqual(shaders.Flat3D.TRANSFORMATION_MATRIX.vectors, 4)
+        self.assertEqual(shaders.Flat3D.TEXTURE_OFFSET.components, gl.Attribute.Components.TWO)
+
+        # Four instances, each with its own transformation and texture offset
+        transformations = gl.Buffer()
+        transformations.set_data(array.array('f', [0.0]*16*4))
+        offsets = gl.Buffer()
+        offsets.set_data(array.array('f', [0.0]*8))
+
+        mesh = gl.Mesh()
+        mesh.count = 3
+        mesh.instance_count = 4
+        mesh.add_vertex_buffer_instanced(transformations, 1, 0, 64, shaders.Flat3D.TRANSFORMATION_MATRIX)
+        mesh.add_vertex_buffer_instanced(offsets, 1, 0, 8, shaders.Flat3D.TEXTURE_OFFSET)
+        a.draw(mesh)
+
+    def test_uniform_buffers(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("uniform buffers not available in ES2")
+
+        a = shaders.Flat3D(shaders.Flat3D.Flags.UNIFORM_BUFFERS|shaders.Flat3D.Flags.MULTI_DRAW, material_count=2, draw_count=8)
+        self.assertEqual(a.material_count, 2)
+        self.assertEqual(a.draw_count, 8)
+        a.draw_offset = 7
+
+        transformation_projection = gl.Buffer()
+        transformation_projection.set_data(b'\x00'*shaders.Flat3D.TRANSFORMATION_PROJECTION_UNIFORM['itemsize']*8)
+        draw = gl.Buffer()
+        draw.set_data(b'\x00'*shaders.Flat3D.DRAW_UNIFORM['itemsize']*8)
+        material = gl.Buffer()
+        material.set_data(b'\x00'*shaders.Flat3D.MATERIAL_UNIFORM['itemsize']*2)
+        a.bind_transformation_projection_buffer(transformation_projection)
+        a.bind_draw_buffer(draw, 0, shaders.Flat3D.DRAW_UNIFORM['itemsize']*8)
+        a.bind_material_buffer(material)
+
+    def test_uniform_buffers_layout(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("uniform buffers not available in ES2")
+
+        self.assertEqual(shaders.Flat2D.TRANSFORMATION_PROJECTION_UNIFORM['itemsize'], 48)
+        self.assertEqual(shaders.Flat3D.TRANSFORMATION_PROJECTION_UNIFORM['itemsize'], 64)
+        self.assertEqual(shaders.Flat3D.MATERIAL_UNIFORM['names'], ['color', 'alpha_mask'])
+        self.assertEqual(shaders.Flat3D.MATERIAL_UNIFORM['offsets'], [0, 16])
+
+    def test_uniform_buffers_errors(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("uniform buffers not available in ES2")
+
+        a = shaders.Flat3D()
+        with self.assertRaisesRegex(AttributeError, "the shader was not created with uniform buffers enabled"):
+            a.bind_draw_buffer(gl.Buffer())
+        with self.assertRaisesRegex(AttributeError, "the shader was not created with uniform buffers enabled"):
+            a.draw_offset = 0
+
+        b = shaders.Flat3D(shaders.Flat3D.Flags.UNIFORM_BUFFERS, draw_count=3)
+        with self.assertRaisesRegex(AttributeError, "the shader was created with uniform buffers enabled"):
+            b.color = Color4()
+        with self.assertRaisesRegex(ValueError, "draw offset 3 out of bounds for 3 draws"):
+            b.draw_offset = 3
+
+    def test_uniform_caching(self):
+        a = shaders.Flat3D()
+        self.assertFalse(a.uniform_caching)
+
+        # Without caching nothing gets skipped
+        a.color = (0.5, 1.0, 0.9)
+        a.color = (0.5, 1.0, 0.9)
+        self.assertEqual(a.skipped_uniform_updates, 0)
+
+        a.uniform_caching = True
+        self.assertTrue(a.uniform_caching)
+        a.color = (0.5, 1.0, 0.9)
+        a.color = (0.5, 1.0, 0.9)
+        a.transformation_projection_matrix = Matrix4()
+        a.transformation_projection_matrix = Matrix4()
+        self.assertEqual(a.skipped_uniform_updates, 2)
+
+        # A different value is not skipped
+        a.color = (0.5, 1.0, 0.8)
+        self.assertEqual(a.skipped_uniform_updates, 2)
+
+        # After invalidation the same value is set again
+        a.invalidate_uniform_cache()
+        a.color = (0.5, 1.0, 0.8)
+        self.assertEqual(a.skipped_uniform_updates, 2)
 
 class VertexColor(GLTestCase):
     def test_init(self):
@@ -101,6 +198,68 @@ class Phong(GLTestCase):
         a.bind_normal_texture(texture)
         a.bind_textures(ambient=texture, diffuse=texture, specular=texture, normal=texture)
 
+    def test_instanced(self):
+        a = shaders.Phong(shaders.Phong.Flags.INSTANCED_TRANSFORMATION|shaders.Phong.Flags.TEXTURE_TRANSFORMATION)
+        a.texture_matrix = Matrix3.translation(Vector2(0.5))
+
+        self.assertEqual(shaders.Phong.TRANSFORMATION_MATRIX.vectors, 4)
+        self.assertEqual(shaders.Phong.NORMAL_MATRIX.vectors, 3)
+        self.assertEqual(shaders.Phong.TEXTURE_OFFSET.components, gl.Attribute.Components.TWO)
+
+    def test_uniform_buffers(self):
+        if magnum.TARGET_GLES2:
+            self.skipTest("uniform buffers not available in ES2")
+
+        a = shaders.Phong(shaders.Phong.Flags.UNIFORM_BUFFERS, light_count=4, material_count=2, draw_count=3)
+        self.assertEqual(a.light_count, 4)
+        self.assertEqual(a.material_count, 2)
+        self.assertEqual(a.draw_count, 3)
+
+        light = gl.Buffer()
+        light.set_data(b'\x00'*shaders.Phong.LIGHT_UNIFORM['itemsize']*4)
+        a.bind_light_buffer(light)
+        self.assertEqual(shaders.Phong.DRAW_UNIFORM['names'], ['normal_matrix', 'material_id', 'object_id', 'light_offset', 'light_count'])
+
+        with self.assertRaisesRegex(AttributeError, "the shader was created with uniform buffers enabled"):
+            a.light_positions = [Vector3()]*4
+
+    def test_light_arrays_buffer(self):
+        a = shaders.Phong(shaders.Phong.Flags.NONE, 2)
+
+        # Tightly packed floats, used directly
+        a.light_positions = memoryview(array.array('f', [0.5, 1.0, 0.3, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[2, 3])
+        a.light_colors = memoryview(array.array('f', [1.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0])).cast('B').cast('f', shape=[2, 4])
+
+        # Doubles, converted
+        a.light_positions = memoryview(array.array('d', [0.5, 1.0, 0.3, 0.0, 0.0, 1.0])).cast('B').cast('d', shape=[2, 3])
+
+    def test_light_arrays_buffer_errors(self):
+        a = shaders.Phong(shaders.Phong.Flags.NONE, 2)
+
+        with self.assertRaisesRegex(BufferError, "expected 2 dimensions but got 1"):
+            a.light_positions = array.array('f', [0.5, 1.0, 0.3])
+        with self.assertRaisesRegex(ValueError, "expected 2 items but got 1"):
+            a.light_positions = memoryview(array.array('f', [0.5, 1.0, 0.3])).cast('B').cast('f', shape=[1, 3])
+        with self.assertRaisesRegex(BufferError, "expected 4 components but got 3"):
+            a.light_colors = memoryview(array.array('f', [0.5, 1.0, 0.3, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[2, 3])
+        with self.assertRaisesRegex(BufferError, "expected format f or d but got i"):
+            a.light_positions = memoryview(array.array('i', [0, 1, 0, 0, 0, 1])).cast('B').cast('i', shape=[2, 3])
+
+    def test_uniform_caching(self):
+        a = shaders.Phong(shaders.Phong.Flags.NONE, 2)
+        a.uniform_caching = True
+        a.shininess = 80.0
+        a.shininess = 80.0
+        a.light_positions = [(0.5, 1.0, 0.3), Vector3()]
+        a.light_positions = [(0.5, 1.0, 0.3), Vector3()]
+        a.light_colors = [Color4(), Color4()]
+        self.assertEqual(a.skipped_uniform_updates, 2)
+
+        # Re-enabling resets the cache
+        a.uniform_caching = True
+        a.shininess = 80.0
+        self.assertEqual(a.skipped_uniform_updates, 2)
+
     def test_uniforms_bindings_errors(self):
         a = shaders.Phong()
         with self.assertRaisesRegex(AttributeError, "the shader was not created with alpha mask enabled"):
@@ -23,11 +23,14 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import array
+import asyncio
 import os
 import sys
 import unittest
 
 from corrade import pluginmanager
+import magnum
 from magnum import *
 from magnum import trade
 
@@ -96,8 +99,213 @@ class MeshData(unittest.TestCase):
 
         mesh = importer.mesh(0)
         self.assertEqual(mesh.primitive, MeshPrimitive.TRIANGLES)
+        self.assertIsNone(mesh.index_data_owner)
+        self.assertIsNone(mesh.vertex_data_owner)
         # TODO: test more, once it's exposed
 
+    def test_init(self):
+        positions = memoryview(array.array('f', [0.0, 0.0, 1.0, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[3, 2])
+        indices = array.array('H', [0, 1, 2, 2, 1, 0])
+        positions_refcount = sys.getrefcount(positions.obj)
+        indices_refcount = sys.getrefcount(indices)
+
+        mesh = trade.MeshData(MeshPrimitive.TRIANGLES, indices, {
+            trade.MeshAttribute.POSITION: positions
+        })
+        self.assertEqual(mesh.primitive, MeshPrimitive.TRIANGLES)
+        self.assertTrue(mesh.is_indexed)
+        self.assertEqual(mesh.index_count, 6)
+        self.assertEqual(mesh.vertex_count, 3)
+        self.assertEqual(mesh.attribute_count, 1)
+
+        # The data are referenced, not copied, so the owners are kept alive
+        self.assertIs(mesh.index_data_owner, indices)
+        self.assertIs(mesh.vertex_data_owner, positions.obj)
+        self.assertEqual(sys.getrefcount(indices), indices_refcount + 1)
+        self.assertEqual(sys.getrefcount(positions.obj), positions_refcount + 1)
+
+        del mesh
+        self.assertEqual(sys.getrefcount(indices), indices_refcount)
+        self.assertEqual(sys.getrefcount(positions.obj), positions_refcount)
+
+    def test_init_separate_attributes(self):
+        positions = memoryview(array.array('f', [0.0, 0.0, 1.0, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[3, 2])
+        colors = memoryview(array.array('B', [255, 0, 0, 0, 255, 0, 0, 0, 255])).cast('B', shape=[3, 3])
+
+        # Attributes from different memory get copied together
+        mesh = trade.MeshData(MeshPrimitive.TRIANGLES, {
+            trade.MeshAttribute.POSITION: positions,
+            trade.MeshAttribute.COLOR: colors
+        })
+        self.assertFalse(mesh.is_indexed)
+        self.assertEqual(mesh.vertex_count, 3)
+        self.assertEqual(mesh.attribute_count, 2)
+        self.assertIsNone(mesh.vertex_data_owner)
+
+    def test_init_errors(self):
+        positions = memoryview(array.array('f', [0.0, 0.0, 1.0, 0.0, 0.0, 1.0])).cast('B').cast('f', shape=[3, 2])
+
+        with self.assertRaisesRegex(ValueError, "expected at least one attribute"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, {})
+        with self.assertRaisesRegex(BufferError, "expected 1 or 2 dimensions but got 3"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, {
+                trade.MeshAttribute.POSITION: positions.cast('B').cast('f', shape=[3, 1, 2])
+            })
+        with self.assertRaisesRegex(BufferError, "expected 1 to 4 components but got 6"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, {
+                trade.MeshAttribute.POSITION: positions.cast('B').cast('f', shape=[1, 6])
+            })
+        with self.assertRaisesRegex(BufferError, "unsupported vertex format q"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, {
+                trade.MeshAttribute.POSITION: array.array('q', [0, 1, 2])
+            })
+        with self.assertRaisesRegex(ValueError, "expected 3 vertices but got 2"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, {
+                trade.MeshAttribute.POSITION: positions,
+                trade.MeshAttribute.TEXTURE_COORDINATES: positions[1:]
+            })
+        with self.assertRaisesRegex(BufferError, "unsupported index format f"):
+            trade.MeshData(MeshPrimitive.TRIANGLES, array.array('f', [0.0]), {
+                trade.MeshAttribute.POSITION: positions
+            })
+
+class ImporterAsync(unittest.TestCase):
+    def run_async(self, coroutine):
+        loop = asyncio.new_event_loop()
+        try:
+            return loop.run_until_complete(coroutine)
+        finally:
+            loop.close()
+
+    def test(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+
+        async def load():
+            await importer.open_file_async(os.path.join(os.path.dirname(__file__), "rgb.png"))
+            return await importer.image2d_async(0)
+
+        image = self.run_async(load())
+        self.assertEqual(image.size, Vector2i(3, 2))
+        self.assertEqual(image.format, PixelFormat.RGB8_UNORM)
+
+    def test_mesh(self):
+        importer = trade.ImporterManager().load_and_instantiate('TinyGltfImporter')
+
+        async def load():
+            await importer.open_file_async(os.path.join(os.path.dirname(__file__), 'mesh.glb'))
+            return await importer.mesh_async(0)
+
+        mesh = self.run_async(load())
+        self.assertEqual(mesh.primitive, MeshPrimitive.TRIANGLES)
+
+    def test_failed(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+
+        async def open_file():
+            await importer.open_file_async('nonexistent.png')
+
+        with self.assertRaisesRegex(RuntimeError, "opening nonexistent.png failed"):
+            self.run_async(open_file())
+
+        importer.open_data(b'bla')
+
+        async def load():
+            await importer.image2d_async(0)
+
+        with self.assertRaisesRegex(RuntimeError, "import failed"):
+            self.run_async(load())
+
+    def test_errors(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+
+        # These are checked right away, without creating a future
+        with self.assertRaisesRegex(RuntimeError, "no file opened"):
+            importer.image2d_async(0)
+
+        importer.open_file(os.path.join(os.path.dirname(__file__), "rgb.png"))
+        with self.assertRaises(IndexError):
+            importer.image2d_async(1)
+
+    def test_busy(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+        importer.open_file(os.path.join(os.path.dirname(__file__), "rgb.png"))
+
+        async def load():
+            first = importer.image2d_async(0)
+            with self.assertRaisesRegex(RuntimeError, "another asynchronous operation is in progress"):
+                importer.image2d_async(0)
+            return await first
+
+        # Force a worker thread so the first operation isn't finished right
+        # away
+        thread_count = magnum.thread_count()
+        magnum.set_thread_count(2)
+        try:
+            self.assertEqual(self.run_async(load()).size, Vector2i(3, 2))
+        finally:
+            magnum.set_thread_count(thread_count)
+
+class ImporterInstrumentation(unittest.TestCase):
+    def tearDown(self):
+        trade.set_importer_instrumentation(False)
+        trade.reset_importer_stats()
+
+    def test(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+
+        # Nothing recorded when disabled
+        importer.open_file(os.path.join(os.path.dirname(__file__), "rgb.png"))
+        self.assertEqual(trade.importer_stats(), {})
+
+        trade.set_importer_instrumentation(True)
+        importer.open_file(os.path.join(os.path.dirname(__file__), "rgb.png"))
+        importer.image2d(0)
+        importer.image2d(0)
+        importer.close()
+
+        stats = trade.importer_stats()['StbImageImporter']
+        self.assertEqual(set(stats.keys()), {'open_file', 'image2d', 'close'})
+        self.assertEqual(stats['open_file']['calls'], 1)
+        self.assertGreater(stats['open_file']['bytes_in'], 0)
+        self.assertEqual(stats['image2d']['calls'], 2)
+        self.assertEqual(stats['image2d']['bytes_out'], 2*3*2*3)
+        self.assertGreaterEqual(stats['image2d']['time'], 0.0)
+
+        trade.reset_importer_stats()
+        self.assertEqual(trade.importer_stats(), {})
+
+    def test_failed_call(self):
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+
+        trade.set_importer_instrumentation(True)
+        with self.assertRaises(RuntimeError):
+            importer.open_data(b'')
+
+        # Failed calls are counted too
+        stats = trade.importer_stats()['StbImageImporter']
+        self.assertEqual(stats['open_data']['calls'], 1)
+        self.assertEqual(stats['open_data']['bytes_in'], 0)
+
+class ImporterTracing(unittest.TestCase):
+    def tearDown(self):
+        magnum.set_tracing(False)
+        magnum.clear_trace()
+
+    def test(self):
+        magnum.clear_trace()
+        magnum.set_tracing(True)
+
+        importer = trade.ImporterManager().load_and_instantiate('StbImageImporter')
+        with TraceZone('load'):
+            importer.open_file(os.path.join(os.path.dirname(__file__), "rgb.png"))
+            importer.image2d(0)
+
+        self.assertEqual([(e['name'], e['category']) for e in magnum.trace_events()], [
+            ('open_file', 'trade'),
+            ('image2d', 'trade'),
+            ('load', 'python')
+        ])
+
 class Importer(unittest.TestCase):
     def test(self):
         manager = trade.ImporterManager()
@@ -0,0 +1,65 @@
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+import unittest
+
+from magnum import *
+from magnum import trade
+
+try:
+    import numpy as np
+except ModuleNotFoundError:
+    raise unittest.SkipTest("numpy not installed")
+
+class MeshData(unittest.TestCase):
+    def test_init_interleaved(self):
+        vertices = np.zeros(4, dtype=[('position', np.float32, 3), ('normal', np.float32, 3)])
+        vertices['position'] = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]
+        vertices['normal'] = (0, 0, 1)
+        indices = np.array([0, 1, 2, 0, 2, 3], dtype=np.uint32)
+
+        # Both columns are views on the same array, so it's referenced
+        # without a copy
+        mesh = trade.MeshData(MeshPrimitive.TRIANGLES, indices, {
+            trade.MeshAttribute.POSITION: vertices['position'],
+            trade.MeshAttribute.NORMAL: vertices['normal']
+        })
+        self.assertEqual(mesh.index_count, 6)
+        self.assertEqual(mesh.vertex_count, 4)
+        self.assertEqual(mesh.attribute_count, 2)
+        self.assertIs(mesh.index_data_owner, indices)
+        self.assertIs(mesh.vertex_data_owner, vertices)
+
+    def test_init_separate(self):
+        positions = np.zeros((4, 3), dtype=np.float32)
+        texture_coordinates = np.zeros((4, 2), dtype=np.float32)
+
+        # Different arrays, copied
+        mesh = trade.MeshData(MeshPrimitive.TRIANGLE_FAN, {
+            trade.MeshAttribute.POSITION: positions,
+            trade.MeshAttribute.TEXTURE_COORDINATES: texture_coordinates
+        })
+        self.assertEqual(mesh.vertex_count, 4)
+        self.assertIsNone(mesh.vertex_data_owner)
@@ -0,0 +1,359 @@
+#ifndef magnum_threadpool_h
+#define magnum_threadpool_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Functions.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "magnum/bootstrap.h"
+
+namespace magnum {
+
+/* A single pool shared by all batch kernels in all modules. The instance
+   lives in the root module and other modules get it through pyThreadPool(),
+   so there's always just one set of worker threads no matter how many
+   modules use it.
+
+   Work is split into tasks of at least grainSize() items, which are
+   distributed round-robin to per-thread queues. Each thread takes tasks from
+   the front of its own queue and once that's empty steals from the back of
+   others. The calling thread participates as well, so a pool with a thread
+   count of N has N - 1 workers. Parallel regions started from inside a task
+   run serially on the thread that started them instead of adding more work
+   to the queues, which prevents nested workloads from oversubscribing the
+   cores.
+
+   The kernels are expected to not throw and to not touch anything Python,
+   as the GIL is released for the whole parallel region. */
+class PyThreadPool {
+    public:
+        struct Stats {
+            std::atomic<std::size_t> regions{};
+            std::atomic<std::size_t> serialRegions{};
+            std::atomic<std::size_t> nestedRegions{};
+            std::atomic<std::size_t> tasks{};
+            std::atomic<std::size_t> steals{};
+            std::atomic<std::size_t> maxQueueDepth{};
+            /* Sum of time spent executing tasks by all threads */
+            std::atomic<std::chrono::steady_clock::rep> busyTime{};
+            /* Wall time of parallel regions multiplied by thread count */
+            std::atomic<std::chrono::steady_clock::rep> availableTime{};
+        };
+
+        explicit PyThreadPool() { start(0, false); }
+
+        ~PyThreadPool() { stop(); }
+
+        std::size_t threadCount() const { return _queues.size(); }
+
+        /* Zero means hardware concurrency. Expects that no parallel region
+           is running. */
+        void setThreadCount(std::size_t count, bool pinThreads) {
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                if(_activeRegions) {
+                    PyErr_SetString(PyExc_RuntimeError, "can't change thread count while a parallel region is running");
+                    throw py::error_already_set{};
+                }
+                /* Any region started from now until the restart is done
+                   will run serially */
+                _reconfiguring = true;
+            }
+
+            /* Pending asynchronous jobs are finished first and those may
+               need the GIL to deliver their results */
+            py::gil_scoped_release release;
+            stop();
+            start(count, pinThreads);
+        }
+
+        std::size_t grainSize() const { return _grainSize; }
+        void setGrainSize(std::size_t size) {
+            if(!size) {
+                PyErr_SetString(PyExc_ValueError, "grain size can't be zero");
+                throw py::error_already_set{};
+            }
+            _grainSize = size;
+        }
+
+        std::size_t queueDepth() const { return _pending; }
+
+        Stats& stats() { return _stats; }
+
+        void resetStats() {
+            _stats.regions = 0;
+            _stats.serialRegions = 0;
+            _stats.nestedRegions = 0;
+            _stats.tasks = 0;
+            _stats.steals = 0;
+            _stats.maxQueueDepth = 0;
+            _stats.busyTime = 0;
+            _stats.availableTime = 0;
+        }
+
+        /* Calls function(begin, end) on disjoint subranges of [0, count).
+           Expects the GIL to be held on entry, releases it for the duration
+           of the region. A zero grain size means grainSize(). */
+        void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function) {
+            if(!count) return;
+            if(!grain) grain = _grainSize;
+
+            /* Nested regions, too small workloads and single-threaded pools
+               run serially, without touching the queues */
+            if(insideTask()) {
+                ++_stats.nestedRegions;
+                function(0, count);
+                return;
+            }
+            const std::size_t taskCount = (count + grain - 1)/grain;
+            bool serial;
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                serial = taskCount < 2 || _queues.size() < 2 || _reconfiguring;
+                if(!serial) ++_activeRegions;
+            }
+            if(serial) {
+                ++_stats.serialRegions;
+                py::gil_scoped_release release;
+                function(0, count);
+                return;
+            }
+
+            ++_stats.regions;
+            const auto begin = std::chrono::steady_clock::now();
+            {
+                py::gil_scoped_release release;
+
+                Region region;
+                region.remaining = taskCount;
+                for(std::size_t i = 0; i != taskCount; ++i) {
+                    Queue& queue = _queues[i % _queues.size()];
+                    std::lock_guard<std::mutex> lock{queue.mutex};
+                    queue.tasks.push_back(Task{&function, &region, nullptr, i*grain, Math::min((i + 1)*grain, count)});
+                }
+                updateMaxQueueDepth(_pending += taskCount);
+                {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                }
+                _condition.notify_all();
+
+                /* The calling thread uses the first queue */
+                insideTask() = true;
+                while(region.remaining && runTask(0));
+                insideTask() = false;
+
+                std::unique_lock<std::mutex> lock{_mutex};
+                _doneCondition.wait(lock, [&region]{ return !region.remaining; });
+                --_activeRegions;
+            }
+            _stats.availableTime += (std::chrono::steady_clock::now() - begin).count()*_queues.size();
+        }
+
+        /* Runs the function on one of the workers without waiting for it to
+           finish. The function is called without the GIL. If the pool has no
+           workers, it's called directly. */
+        void async(std::function<void()> function) {
+            std::function<void()>* job = new std::function<void()>{std::move(function)};
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                if(_queues.size() >= 2 && !_reconfiguring) {
+                    /* Spread over worker queues only, the first one is used
+                       by threads calling parallelFor() */
+                    Queue& queue = _queues[1 + _nextAsyncQueue++ % (_queues.size() - 1)];
+                    std::lock_guard<std::mutex> queueLock{queue.mutex};
+                    queue.tasks.push_back(Task{nullptr, nullptr, job, 0, 0});
+                    updateMaxQueueDepth(++_pending);
+                    job = nullptr;
+                }
+            }
+
+            if(job) {
+                py::gil_scoped_release release;
+                (*job)();
+                delete job;
+            } else _condition.notify_all();
+        }
+
+    private:
+        struct Region {
+            std::atomic<std::size_t> remaining;
+        };
+
+        struct Task {
+            const std::function<void(std::size_t, std::size_t)>* function;
+            Region* region;
+            /* Owned, non-null for asynchronous jobs */
+            std::function<void()>* job;
+            std::size_t begin, end;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        static bool& insideTask() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        void start(std::size_t count, bool pinThreads) {
+            if(!count) count = Math::max(std::thread::hardware_concurrency(), 1u);
+
+            _stopping = false;
+            _queues = Containers::Array<Queue>{count};
+            _workers = Containers::Array<std::thread>{count - 1};
+            for(std::size_t i = 0; i != _workers.size(); ++i) {
+                _workers[i] = std::thread{&PyThreadPool::run, this, i + 1};
+                #ifdef __linux__
+                if(pinThreads) {
+                    cpu_set_t cpus;
+                    CPU_ZERO(&cpus);
+                    CPU_SET((i + 1) % std::thread::hardware_concurrency(), &cpus);
+                    pthread_setaffinity_np(_workers[i].native_handle(), sizeof(cpu_set_t), &cpus);
+                }
+                #else
+                static_cast<void>(pinThreads);
+                #endif
+            }
+
+            std::lock_guard<std::mutex> lock{_mutex};
+            _reconfiguring = false;
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _stopping = true;
+            }
+            _condition.notify_all();
+            for(std::thread& worker: _workers) worker.join();
+            _workers = nullptr;
+        }
+
+        void run(std::size_t index) {
+            insideTask() = true;
+            for(;;) {
+                {
+                    std::unique_lock<std::mutex> lock{_mutex};
+                    _condition.wait(lock, [this]{ return _stopping || _pending; });
+                    /* Finish all queued work before exiting so asynchronous
+                       jobs don't get lost when the pool gets resized */
+                    if(_stopping && !_pending) return;
+                }
+                runTask(index);
+            }
+        }
+
+        /* Runs one task from own queue or a stolen one, returns false if
+           all queues were empty */
+        bool runTask(std::size_t index) {
+            Task task;
+            if(!pop(index, task)) return false;
+
+            const auto begin = std::chrono::steady_clock::now();
+            if(task.job) {
+                (*task.job)();
+                delete task.job;
+            } else (*task.function)(task.begin, task.end);
+            _stats.busyTime += (std::chrono::steady_clock::now() - begin).count();
+            ++_stats.tasks;
+
+            if(task.region && !--task.region->remaining) {
+                {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                }
+                _doneCondition.notify_all();
+            }
+            return true;
+        }
+
+        bool pop(std::size_t index, Task& task) {
+            {
+                Queue& own = _queues[index];
+                std::lock_guard<std::mutex> lock{own.mutex};
+                if(!own.tasks.empty()) {
+                    task = own.tasks.front();
+                    own.tasks.pop_front();
+                    --_pending;
+                    return true;
+                }
+            }
+
+            for(std::size_t i = 1; i != _queues.size(); ++i) {
+                Queue& other = _queues[(index + i) % _queues.size()];
+                std::lock_guard<std::mutex> lock{other.mutex};
+                if(!other.tasks.empty()) {
+                    task = other.tasks.back();
+                    other.tasks.pop_back();
+                    --_pending;
+                    ++_stats.steals;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void updateMaxQueueDepth(std::size_t depth) {
+            std::size_t max = _stats.maxQueueDepth;
+            while(depth > max && !_stats.maxQueueDepth.compare_exchange_weak(max, depth));
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _condition, _doneCondition;
+        bool _stopping{}, _reconfiguring{};
+        std::size_t _activeRegions{};
+        std::size_t _nextAsyncQueue{};
+        std::atomic<std::size_t> _pending{};
+        std::atomic<std::size_t> _grainSize{1024};
+        Containers::Array<Queue> _queues;
+        Containers::Array<std::thread> _workers;
+        Stats _stats;
+};
+
+/* The instance is owned by the root module, see sharedThreadPool() in
+   magnum.threadpool.cpp */
+inline PyThreadPool& pyThreadPool() {
+    static PyThreadPool& pool = *static_cast<PyThreadPool*>(py::module::import("_magnum").attr("_thread_pool").cast<py::capsule>());
+    return pool;
+}
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef magnum_tracing_h
+#define magnum_tracing_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+#include "magnum/bootstrap.h"
+
+namespace magnum {
+
+struct PyTraceEvent {
+    std::string name;
+    const char* category;
+    std::thread::id thread;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::duration duration;
+};
+
+struct PyTrampolineStats {
+    std::size_t calls{};
+    std::chrono::steady_clock::duration time{};
+};
+
+/* Collects timed zones from all modules as well as from Python code. The
+   instance lives in the root module and other modules get it through
+   pyTracer(), so native and Python zones end up on a single timeline. When
+   disabled, a zone costs just a relaxed atomic load. */
+class PyTracer {
+    public:
+        bool isEnabled() const {
+            return _enabled.load(std::memory_order_relaxed);
+        }
+
+        void setEnabled(bool enabled) {
+            _enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        void add(std::string name, const char* category, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _events.push_back(PyTraceEvent{std::move(name), category, std::this_thread::get_id(), begin, end - begin});
+        }
+
+        std::vector<PyTraceEvent> events() {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return _events;
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _events.clear();
+        }
+
+        /* Counting of C++-to-Python virtual calls, keyed by the Python type
+           name and the overriden function name. Zone names qualified with a
+           C++ class name such as "Drawable.draw" get the qualifier replaced
+           with the Python type name. */
+        bool isCountingTrampolines() const {
+            return _countingTrampolines.load(std::memory_order_relaxed);
+        }
+
+        void setCountingTrampolines(bool enabled) {
+            _countingTrampolines.store(enabled, std::memory_order_relaxed);
+        }
+
+        void addTrampolineCall(const char* type, const char* name, std::chrono::steady_clock::duration time) {
+            std::lock_guard<std::mutex> lock{_mutex};
+            const char* const function = std::strrchr(name, '.');
+            PyTrampolineStats& stats = _trampolineStats[std::string{type} + '.' + (function ? function + 1 : name)];
+            ++stats.calls;
+            stats.time += time;
+        }
+
+        std::map<std::string, PyTrampolineStats> trampolineStats() {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return _trampolineStats;
+        }
+
+        void resetTrampolineStats() {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _trampolineStats.clear();
+        }
+
+    private:
+        std::atomic<bool> _enabled{}, _countingTrampolines{};
+        std::mutex _mutex;
+        std::vector<PyTraceEvent> _events;
+        std::map<std::string, PyTrampolineStats> _trampolineStats;
+};
+
+/* The instance is owned by the root module, see sharedTracer() in
+   magnum.tracing.cpp */
+inline PyTracer& pyTracer() {
+    static PyTracer& tracer = *static_cast<PyTracer*>(py::module::import("_magnum").attr("_tracer").cast<py::capsule>());
+    return tracer;
+}
+
+/* Records the time between construction and destruction if tracing is
+   enabled. The name and category are expected to be global literals. */
+class PyTraceZone {
+    public:
+        explicit PyTraceZone(const char* category, const char* name): _tracer{pyTracer().isEnabled() ? &pyTracer() : nullptr}, _category{category}, _name{name} {
+            if(_tracer) _begin = std::chrono::steady_clock::now();
+        }
+
+        PyTraceZone(const PyTraceZone&) = delete;
+        PyTraceZone& operator=(const PyTraceZone&) = delete;
+
+        ~PyTraceZone() {
+            if(_tracer) _tracer->add(_name, _category, _begin, std::chrono::steady_clock::now());
+        }
+
+    private:
+        PyTracer* _tracer;
+        const char* _category;
+        const char* _name;
+        std::chrono::steady_clock::time_point _begin;
+};
+
+/* Name of the Python type of an instance bound with given C++ type, which is
+   the same type as passed to PYBIND11_OVERLOAD_NAME() */
+template<class T> const char* pyTrampolineTypeName(const T* self) {
+    py::gil_scoped_acquire gil;
+    const py::detail::type_info* info = py::detail::get_type_info(typeid(T));
+    const py::handle object = info ? py::detail::get_object_handle(self, info) : py::handle{};
+    return object ? Py_TYPE(object.ptr())->tp_name : "<unknown>";
+}
+
+/* A trace zone that additionally counts trampoline calls if enabled. Put at
+   the beginning of a function calling into a Python override, so the
+   lookup of the override and the GIL round-trip are counted as well. */
+class PyTrampolineZone {
+    public:
+        template<class T> explicit PyTrampolineZone(const T* self, const char* category, const char* name): _zone{category, name}, _type{pyTracer().isCountingTrampolines() ? pyTrampolineTypeName(self) : nullptr}, _name{name} {
+            if(_type) _begin = std::chrono::steady_clock::now();
+        }
+
+        PyTrampolineZone(const PyTrampolineZone&) = delete;
+        PyTrampolineZone& operator=(const PyTrampolineZone&) = delete;
+
+        ~PyTrampolineZone() {
+            if(_type) pyTracer().addTrampolineCall(_type, _name, std::chrono::steady_clock::now() - _begin);
+        }
+
+    private:
+        PyTraceZone _zone;
+        const char* _type;
+        const char* _name;
+        std::chrono::steady_clock::time_point _begin;
+};
+
+}
+
+#endif
@@ -23,19 +23,34 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 #include <pybind11/pybind11.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/VertexFormat.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "Corrade/Python.h"
 #include "Corrade/Containers/Python.h"
 #include "Magnum/Python.h"
+#include "Magnum/Trade/Python.h"
 
 #include "corrade/pluginmanager.h"
 #include "magnum/bootstrap.h"
+#include "magnum/threadpool.h"
+#include "magnum/tracing.h"
 
 namespace magnum {
 
@@ -136,6 +151,285 @@ template<UnsignedInt dimensions> void imageData(py::class_<Trade::ImageData<dime
         }, "View on pixel data");
 }
 
+/* Buffer protocol format strings can have a byte order / alignment prefix,
+   which is fine to ignore for native data */
+char bufferFormat(const Py_buffer& buffer) {
+    const char* format = buffer.format ? buffer.format : "B";
+    if(*format == '@' || *format == '=' || *format == '<') ++format;
+    return format[0] && !format[1] ? format[0] : '\0';
+}
+
+bool vertexFormatForBuffer(const Py_buffer& buffer, VertexFormat& out) {
+    const char format = bufferFormat(buffer);
+    if(format == 'f' && buffer.itemsize == 4) out = VertexFormat::Float;
+    else if(format == 'd' && buffer.itemsize == 8) out = VertexFormat::Double;
+    else if(format == 'e' && buffer.itemsize == 2) out = VertexFormat::Half;
+    else if(format == 'B' || format == 'H' || format == 'I' || format == 'L') {
+        if(buffer.itemsize == 1) out = VertexFormat::UnsignedByte;
+        else if(buffer.itemsize == 2) out = VertexFormat::UnsignedShort;
+        else if(buffer.itemsize == 4) out = VertexFormat::UnsignedInt;
+        else return false;
+    } else if(format == 'b' || format == 'h' || format == 'i' || format == 'l') {
+        if(buffer.itemsize == 1) out = VertexFormat::Byte;
+        else if(buffer.itemsize == 2) out = VertexFormat::Short;
+        else if(buffer.itemsize == 4) out = VertexFormat::Int;
+        else return false;
+    } else return false;
+    return true;
+}
+
+bool indexTypeForBuffer(const Py_buffer& buffer, MeshIndexType& out) {
+    const char format = bufferFormat(buffer);
+    if(format != 'B' && format != 'H' && format != 'I' && format != 'L')
+        return false;
+    if(buffer.itemsize == 1) out = MeshIndexType::UnsignedByte;
+    else if(buffer.itemsize == 2) out = MeshIndexType::UnsignedShort;
+    else if(buffer.itemsize == 4) out = MeshIndexType::UnsignedInt;
+    else return false;
+    return true;
+}
+
+/* Object that actually owns the memory -- numpy views and memoryviews point
+   to their parent, so e.g. two columns of a structured numpy array resolve to
+   the same array */
+py::object bufferOwner(py::handle obj) {
+    py::object owner = py::reinterpret_borrow<py::object>(obj);
+    for(;;) {
+        py::object parent;
+        if(PyMemoryView_Check(owner.ptr())) {
+            PyObject* base = PyMemoryView_GET_BUFFER(owner.ptr())->obj;
+            if(base) parent = py::reinterpret_borrow<py::object>(base);
+        } else if(py::hasattr(owner, "base"))
+            parent = owner.attr("base");
+
+        if(!parent || parent.is_none() || !PyObject_CheckBuffer(parent.ptr()))
+            return owner;
+        owner = std::move(parent);
+    }
+}
+
+struct AttributeBuffer {
+    Trade::MeshAttribute name;
+    VertexFormat format;
+    const char* data;
+    std::size_t count;
+    std::ptrdiff_t stride;
+    std::size_t size;
+    py::object owner;
+};
+
+Trade::PyMeshDataHolder<Trade::MeshData> meshData(MeshPrimitive primitive, py::handle indices, py::dict attributes) {
+    if(attributes.empty()) {
+        PyErr_SetString(PyExc_ValueError, "expected at least one attribute");
+        throw py::error_already_set{};
+    }
+
+    /* Gather the attributes. The buffers are released right after, the views
+       stay valid because the owners are kept alive by the holder. */
+    std::vector<AttributeBuffer> attributeBuffers;
+    for(const auto& item: attributes) {
+        /* GCC 4.8 otherwise loudly complains about missing initializers */
+        Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+        if(PyObject_GetBuffer(item.second.ptr(), &buffer, PyBUF_FORMAT|PyBUF_STRIDES) != 0)
+            throw py::error_already_set{};
+        Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+
+        if(buffer.ndim != 1 && buffer.ndim != 2) {
+            PyErr_Format(PyExc_BufferError, "expected 1 or 2 dimensions but got %i", buffer.ndim);
+            throw py::error_already_set{};
+        }
+
+        const std::size_t componentCount = buffer.ndim == 2 ? buffer.shape[1] : 1;
+        if(componentCount < 1 || componentCount > 4) {
+            PyErr_Format(PyExc_BufferError, "expected 1 to 4 components but got %zu", componentCount);
+            throw py::error_already_set{};
+        }
+        if(buffer.ndim == 2 && buffer.strides[1] != buffer.itemsize) {
+            PyErr_SetString(PyExc_BufferError, "expected contiguous components");
+            throw py::error_already_set{};
+        }
+
+        VertexFormat componentFormat;
+        if(!vertexFormatForBuffer(buffer, componentFormat)) {
+            PyErr_Format(PyExc_BufferError, "unsupported vertex format %s", buffer.format);
+            throw py::error_already_set{};
+        }
+
+        const std::size_t count = buffer.shape[0];
+        if(!attributeBuffers.empty() && count != attributeBuffers.front().count) {
+            PyErr_Format(PyExc_ValueError, "expected %zu vertices but got %zu", attributeBuffers.front().count, count);
+            throw py::error_already_set{};
+        }
+
+        attributeBuffers.push_back({py::cast<Trade::MeshAttribute>(item.first),
+            vertexFormat(componentFormat, componentCount, false),
+            static_cast<const char*>(buffer.buf), count, buffer.strides[0],
+            buffer.itemsize*componentCount, bufferOwner(item.second)});
+    }
+
+    /* If all attributes are in memory of the same owner, reference it
+       directly. Otherwise (or if the owner isn't contiguous) copy all
+       attributes into a single non-interleaved array. */
+    py::object vertexDataOwner = attributeBuffers.front().owner;
+    Containers::ArrayView<const void> vertexData;
+    for(const AttributeBuffer& attribute: attributeBuffers) if(!attribute.owner.is(vertexDataOwner)) {
+        vertexDataOwner = py::none{};
+        break;
+    }
+    if(!vertexDataOwner.is_none()) {
+        Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+        if(PyObject_GetBuffer(vertexDataOwner.ptr(), &buffer, PyBUF_SIMPLE) != 0) {
+            PyErr_Clear();
+            vertexDataOwner = py::none{};
+        } else {
+            Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+            const char* begin = static_cast<const char*>(buffer.buf);
+            const char* end = begin + buffer.len;
+            for(const AttributeBuffer& attribute: attributeBuffers) {
+                const char* first = attribute.data + (attribute.stride < 0 ? std::ptrdiff_t(attribute.count - 1)*attribute.stride : 0);
+                const char* last = attribute.data + (attribute.stride < 0 ? 0 : std::ptrdiff_t(attribute.count - 1)*attribute.stride) + attribute.size;
+                if(first < begin || last > end) {
+                    vertexDataOwner = py::none{};
+                    break;
+                }
+            }
+            if(!vertexDataOwner.is_none())
+                vertexData = {buffer.buf, std::size_t(buffer.len)};
+        }
+    }
+
+    Containers::Array<char> vertexDataCopy;
+    Containers::Array<Trade::MeshAttributeData> attributeData{attributeBuffers.size()};
+    if(!vertexDataOwner.is_none()) {
+        for(std::size_t i = 0; i != attributeBuffers.size(); ++i) {
+            const AttributeBuffer& attribute = attributeBuffers[i];
+            attributeData[i] = Trade::MeshAttributeData{attribute.name, attribute.format,
+                Containers::StridedArrayView1D<const void>{vertexData, attribute.data, attribute.count, attribute.stride}};
+        }
+    } else {
+        std::size_t size = 0;
+        for(const AttributeBuffer& attribute: attributeBuffers)
+            size += attribute.count*attribute.size;
+        vertexDataCopy = Containers::Array<char>{Containers::NoInit, size};
+
+        std::size_t offset = 0;
+        for(std::size_t i = 0; i != attributeBuffers.size(); ++i) {
+            const AttributeBuffer& attribute = attributeBuffers[i];
+            char* out = vertexDataCopy + offset;
+            for(std::size_t j = 0; j != attribute.count; ++j)
+                std::memcpy(out + j*attribute.size, attribute.data + std::ptrdiff_t(j)*attribute.stride, attribute.size);
+            attributeData[i] = Trade::MeshAttributeData{attribute.name, attribute.format,
+                Containers::StridedArrayView1D<const void>{vertexDataCopy, out, attribute.count, std::ptrdiff_t(attribute.size)}};
+            offset += attribute.count*attribute.size;
+        }
+    }
+
+    /* Non-indexed mesh */
+    if(indices.is_none()) {
+        if(vertexDataOwner.is_none())
+            return Trade::PyMeshDataHolder<Trade::MeshData>{new Trade::MeshData{primitive, std::move(vertexDataCopy), std::move(attributeData)}, py::none{}, py::none{}};
+        return Trade::PyMeshDataHolder<Trade::MeshData>{new Trade::MeshData{primitive, Trade::DataFlags{}, vertexData, std::move(attributeData)}, py::none{}, vertexDataOwner};
+    }
+
+    /* Indexed mesh, the index buffer is always referenced directly */
+    Py_buffer buffer{nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr};
+    if(PyObject_GetBuffer(indices.ptr(), &buffer, PyBUF_FORMAT) != 0)
+        throw py::error_already_set{};
+    Containers::ScopeGuard e{&buffer, PyBuffer_Release};
+
+    if(buffer.ndim != 1) {
+        PyErr_Format(PyExc_BufferError, "expected 1 dimension for indices but got %i", buffer.ndim);
+        throw py::error_already_set{};
+    }
+
+    MeshIndexType indexType;
+    if(!indexTypeForBuffer(buffer, indexType)) {
+        PyErr_Format(PyExc_BufferError, "unsupported index format %s", buffer.format);
+        throw py::error_already_set{};
+    }
+
+    const Containers::ArrayView<const void> indexData{buffer.buf, std::size_t(buffer.len)};
+    const Trade::MeshIndexData indexView{indexType, indexData};
+    py::object indexDataOwner = bufferOwner(indices);
+    if(vertexDataOwner.is_none())
+        return Trade::PyMeshDataHolder<Trade::MeshData>{new Trade::MeshData{primitive, Trade::DataFlags{}, indexData, indexView, std::move(vertexDataCopy), std::move(attributeData)}, indexDataOwner, py::none{}};
+    return Trade::PyMeshDataHolder<Trade::MeshData>{new Trade::MeshData{primitive, Trade::DataFlags{}, indexData, indexView, Trade::DataFlags{}, vertexData, std::move(attributeData)}, indexDataOwner, vertexDataOwner};
+}
+
+/* Opt-in instrumentation of importer calls, aggregated per plugin and
+   function name. Global so it covers importers created from anywhere. */
+struct ImporterCallStats {
+    UnsignedLong calls{};
+    std::chrono::steady_clock::duration time{};
+    UnsignedLong bytesIn{};
+    UnsignedLong bytesOut{};
+};
+
+struct ImporterInstrumentation {
+    bool enabled{};
+    std::map<std::string, std::map<std::string, ImporterCallStats>> stats;
+};
+
+ImporterInstrumentation& importerInstrumentation() {
+    static ImporterInstrumentation instrumentation;
+    return instrumentation;
+}
+
+/* Adds the call to the stats on destruction, so calls that throw are counted
+   as well. Does nothing if instrumentation is disabled. */
+class ImporterCallTimer {
+    public:
+        explicit ImporterCallTimer(Trade::AbstractImporter& importer, const char* function): _zone{"trade", function}, _stats{importerInstrumentation().enabled ? &importerInstrumentation().stats[importer.plugin()][function] : nullptr}, _begin{std::chrono::steady_clock::now()} {}
+
+        ImporterCallTimer(const ImporterCallTimer&) = delete;
+        ImporterCallTimer& operator=(const ImporterCallTimer&) = delete;
+
+        ~ImporterCallTimer() {
+            if(!_stats) return;
+            ++_stats->calls;
+            _stats->time += std::chrono::steady_clock::now() - _begin;
+        }
+
+        void addBytesIn(std::size_t bytes) {
+            if(_stats) _stats->bytesIn += bytes;
+        }
+
+        void addBytesOut(std::size_t bytes) {
+            if(_stats) _stats->bytesOut += bytes;
+        }
+
+    private:
+        PyTraceZone _zone;
+        ImporterCallStats* _stats;
+        std::chrono::steady_clock::time_point _begin;
+};
+
+template<class> struct ImporterFunction;
+template<> struct ImporterFunction<Trade::MeshData> {
+    static const char* name() { return "mesh"; }
+    static std::size_t dataSize(const Trade::MeshData& data) {
+        return data.indexData().size() + data.vertexData().size();
+    }
+};
+template<> struct ImporterFunction<Trade::ImageData1D> {
+    static const char* name() { return "image1d"; }
+    static std::size_t dataSize(const Trade::ImageData1D& data) {
+        return data.data().size();
+    }
+};
+template<> struct ImporterFunction<Trade::ImageData2D> {
+    static const char* name() { return "image2d"; }
+    static std::size_t dataSize(const Trade::ImageData2D& data) {
+        return data.data().size();
+    }
+};
+template<> struct ImporterFunction<Trade::ImageData3D> {
+    static const char* name() { return "image3d"; }
+    static std::size_t dataSize(const Trade::ImageData3D& data) {
+        return data.data().size();
+    }
+};
+
 /* For some reason having ...Args as the second (and not last) template
    argument does not work. So I'm listing all variants here ... which are
    exactly two, in fact. */
@@ -206,6 +500,8 @@ template<class R, Containers::Optional<R>(Trade::AbstractImporter::*f)(UnsignedI
         throw py::error_already_set{};
     }
 
+    ImporterCallTimer timer{self, ImporterFunction<R>::name()};
+
     /** @todo log redirection -- but we'd need assertions to not be part of
         that so when it dies, the user can still see why */
     Containers::Optional<R> out = (self.*f)(id, level);
@@ -214,9 +510,126 @@ template<class R, Containers::Optional<R>(Trade::AbstractImporter::*f)(UnsignedI
         throw py::error_already_set{};
     }
 
+    timer.addBytesOut(ImporterFunction<R>::dataSize(*out));
+
     return *std::move(out);
 }
 
+/* Importers that have an asynchronous operation in progress. The importer
+   isn't thread-safe, so only one such operation is allowed at a time.
+   Accessed only with the GIL held. */
+std::unordered_set<const Trade::AbstractImporter*>& busyImporters() {
+    static std::unordered_set<const Trade::AbstractImporter*> importers;
+    return importers;
+}
+
+struct ImporterOpened {};
+
+inline std::size_t importerDataSize(const ImporterOpened&) { return 0; }
+template<class T> std::size_t importerDataSize(const T& data) {
+    return ImporterFunction<T>::dataSize(data);
+}
+
+/* State of an asynchronous importer call. Holds Python objects, so it's
+   created and deleted only with the GIL held. */
+template<class R> struct ImporterAsyncCall {
+    /* The importer instance is kept alive by the Python object, the pointer
+       is for use without the GIL */
+    py::object importer;
+    Trade::AbstractImporter* instance;
+    py::object loop;
+    py::object future;
+    const char* function;
+    std::string error;
+    std::size_t bytesIn;
+    Containers::Optional<R> result;
+    std::chrono::steady_clock::duration time{};
+};
+
+inline py::object importerAsyncResult(ImporterOpened) { return py::none{}; }
+template<class T> py::object importerAsyncResult(T&& data) {
+    return py::cast(std::move(data));
+}
+
+template<class R> void importerAsyncFinish(ImporterAsyncCall<R>* callPointer) {
+    std::unique_ptr<ImporterAsyncCall<R>> call{callPointer};
+    busyImporters().erase(call->instance);
+
+    if(importerInstrumentation().enabled) {
+        ImporterCallStats& stats = importerInstrumentation().stats[call->instance->plugin()][call->function];
+        ++stats.calls;
+        stats.time += call->time;
+        stats.bytesIn += call->bytesIn;
+        if(call->result) stats.bytesOut += importerDataSize(*call->result);
+    }
+
+    /* The awaiting task might have been cancelled in the meantime */
+    if(py::cast<bool>(call->future.attr("cancelled")())) return;
+
+    if(!call->result) {
+        call->future.attr("set_exception")(py::reinterpret_borrow<py::object>(PyExc_RuntimeError)(call->error));
+        return;
+    }
+
+    call->future.attr("set_result")(importerAsyncResult(*std::move(call->result)));
+}
+
+/* Runs the work on the shared thread pool and returns an asyncio future that
+   gets resolved on the event loop thread once the work is done */
+template<class R> py::object importerAsync(py::object importer, const char* function, std::size_t bytesIn, std::string error, std::function<Containers::Optional<R>(Trade::AbstractImporter&)> work) {
+    auto& self = py::cast<Trade::AbstractImporter&>(importer);
+    if(!busyImporters().insert(&self).second) {
+        PyErr_SetString(PyExc_RuntimeError, "another asynchronous operation is in progress");
+        throw py::error_already_set{};
+    }
+
+    py::object loop = py::module::import("asyncio").attr("get_event_loop")();
+    py::object future = loop.attr("create_future")();
+    auto* call = new ImporterAsyncCall<R>{std::move(importer), &self, loop, future, function, std::move(error), bytesIn, {}};
+
+    pyThreadPool().async([call, work]() {
+        const auto begin = std::chrono::steady_clock::now();
+        call->result = work(*call->instance);
+        call->time = std::chrono::steady_clock::now() - begin;
+
+        py::gil_scoped_acquire gil;
+        try {
+            call->loop.attr("call_soon_threadsafe")(py::cpp_function{[call]() {
+                importerAsyncFinish(call);
+            }});
+        } catch(py::error_already_set&) {
+            /* The loop got closed, nobody is waiting for the result
+               anymore */
+            busyImporters().erase(call->instance);
+            delete call;
+        }
+    });
+
+    return future;
+}
+
+template<class R, Containers::Optional<R>(Trade::AbstractImporter::*f)(UnsignedInt, UnsignedInt), UnsignedInt(Trade::AbstractImporter::*bounds)() const, UnsignedInt(Trade::AbstractImporter::*levelBounds)(UnsignedInt)> py::object checkOpenedBoundsResultAsync(py::object importer, UnsignedInt id, UnsignedInt level) {
+    auto& self = py::cast<Trade::AbstractImporter&>(importer);
+    if(!self.isOpened()) {
+        PyErr_SetString(PyExc_RuntimeError, "no file opened");
+        throw py::error_already_set{};
+    }
+
+    if(id >= (self.*bounds)()) {
+        PyErr_SetNone(PyExc_IndexError);
+        throw py::error_already_set{};
+    }
+
+    if(level >= (self.*levelBounds)(id)) {
+        PyErr_SetNone(PyExc_IndexError);
+        throw py::error_already_set{};
+    }
+
+    return importerAsync<R>(std::move(importer), ImporterFunction<R>::name(), 0, "import failed", [id, level](Trade::AbstractImporter& self) {
+        return (self.*f)(id, level);
+    });
+}
+
 }
 
 void trade(py::module& m) {
@@ -225,12 +638,33 @@ void trade(py::module& m) {
     /* AbstractImporter depends on this */
     py::module::import("corrade.pluginmanager");
 
-    py::class_<Trade::MeshData>{m, "MeshData", "Mesh data"}
+    py::enum_<Trade::MeshAttribute>{m, "MeshAttribute", "Mesh attribute name"}
+        .value("POSITION", Trade::MeshAttribute::Position)
+        .value("TANGENT", Trade::MeshAttribute::Tangent)
+        .value("BITANGENT", Trade::MeshAttribute::Bitangent)
+        .value("NORMAL", Trade::MeshAttribute::Normal)
+        .value("TEXTURE_COORDINATES", Trade::MeshAttribute::TextureCoordinates)
+        .value("COLOR", Trade::MeshAttribute::Color)
+        .value("OBJECT_ID", Trade::MeshAttribute::ObjectId);
+
+    py::class_<Trade::MeshData, Trade::PyMeshDataHolder<Trade::MeshData>>{m, "MeshData", "Mesh data"}
+        .def(py::init([](MeshPrimitive primitive, py::object indices, py::dict attributes) {
+            return meshData(primitive, indices, attributes);
+        }), "Construct an indexed mesh referencing external data", py::arg("primitive"), py::arg("indices"), py::arg("attributes"))
+        .def(py::init([](MeshPrimitive primitive, py::dict attributes) {
+            return meshData(primitive, py::none{}, attributes);
+        }), "Construct a non-indexed mesh referencing external data", py::arg("primitive"), py::arg("attributes"))
         .def_property_readonly("primitive", &Trade::MeshData::primitive, "Primitive")
         .def_property_readonly("is_indexed", &Trade::MeshData::isIndexed, "Whether the mesh is indexed")
         .def_property_readonly("vertex_count", &Trade::MeshData::vertexCount)
         .def_property_readonly("index_count", &Trade::MeshData::indexCount)
-        .def_property_readonly("attribute_count", static_cast<UnsignedInt(Trade::MeshData::*)() const>(&Trade::MeshData::attributeCount));
+        .def_property_readonly("attribute_count", static_cast<UnsignedInt(Trade::MeshData::*)() const>(&Trade::MeshData::attributeCount))
+        .def_property_readonly("index_data_owner", [](Trade::MeshData& self) {
+            return pyObjectHolderFor<Trade::PyMeshDataHolder>(self).indexDataOwner;
+        }, "Index data memory owner")
+        .def_property_readonly("vertex_data_owner", [](Trade::MeshData& self) {
+            return pyObjectHolderFor<Trade::PyMeshDataHolder>(self).vertexDataOwner;
+        }, "Vertex data memory owner");
 
     py::class_<Trade::ImageData1D> imageData1D{m, "ImageData1D", "One-dimensional image data"};
     py::class_<Trade::ImageData2D> imageData2D{m, "ImageData2D", "Two-dimensional image data"};
@@ -249,6 +683,9 @@ void trade(py::module& m) {
         /** @todo features (once moved outside of the importer) */
         .def_property_readonly("is_opened", &Trade::AbstractImporter::isOpened, "Whether any file is opened")
         .def("open_data", [](Trade::AbstractImporter& self, Containers::ArrayView<const char> data) {
+            ImporterCallTimer timer{self, "open_data"};
+            timer.addBytesIn(data.size());
+
             /** @todo log redirection -- but we'd need assertions to not be
                 part of that so when it dies, the user can still see why */
             if(self.openData(data)) return;
@@ -257,6 +694,12 @@ void trade(py::module& m) {
             throw py::error_already_set{};
         }, "Open raw data", py::arg("data"))
         .def("open_file", [](Trade::AbstractImporter& self, const std::string& filename) {
+            ImporterCallTimer timer{self, "open_file"};
+            if(importerInstrumentation().enabled) {
+                if(const Containers::Optional<std::size_t> size = Utility::Directory::fileSize(filename))
+                    timer.addBytesIn(*size);
+            }
+
             /** @todo log redirection -- but we'd need assertions to not be
                 part of that so when it dies, the user can still see why */
             if(self.openFile(filename)) return;
@@ -264,7 +707,22 @@ void trade(py::module& m) {
             PyErr_Format(PyExc_RuntimeError, "opening %s failed", filename.data());
             throw py::error_already_set{};
         }, "Open a file", py::arg("filename"))
-        .def("close", &Trade::AbstractImporter::close, "Close currently opened file")
+        .def("open_file_async", [](py::object importer, const std::string& filename) {
+            std::size_t bytesIn = 0;
+            if(importerInstrumentation().enabled) {
+                if(const Containers::Optional<std::size_t> size = Utility::Directory::fileSize(filename))
+                    bytesIn = *size;
+            }
+
+            return importerAsync<ImporterOpened>(std::move(importer), "open_file", bytesIn, "opening " + filename + " failed", [filename](Trade::AbstractImporter& self) -> Containers::Optional<ImporterOpened> {
+                if(self.openFile(filename)) return ImporterOpened{};
+                return {};
+            });
+        }, "Open a file asynchronously", py::arg("filename"))
+        .def("close", [](Trade::AbstractImporter& self) {
+            ImporterCallTimer timer{self, "close"};
+            self.close();
+        }, "Close currently opened file")
 
         /** @todo all other data types */
         .def_property_readonly("mesh_count", checkOpened<UnsignedInt, &Trade::AbstractImporter::meshCount>, "Mesh count")
@@ -288,10 +746,41 @@ void trade(py::module& m) {
         .def("image3d_name", checkOpenedBounds<std::string, &Trade::AbstractImporter::image3DName, &Trade::AbstractImporter::image3DCount>, "Three-dimensional image name", py::arg("id"))
         .def("image1d", checkOpenedBoundsResult<Trade::ImageData1D, &Trade::AbstractImporter::image1D, &Trade::AbstractImporter::image1DCount, &Trade::AbstractImporter::image1DLevelCount>, "One-dimensional image", py::arg("id"), py::arg("level") = 0)
         .def("image2d", checkOpenedBoundsResult<Trade::ImageData2D, &Trade::AbstractImporter::image2D, &Trade::AbstractImporter::image2DCount, &Trade::AbstractImporter::image2DLevelCount>, "Two-dimensional image", py::arg("id"), py::arg("level") = 0)
-        .def("image3d", checkOpenedBoundsResult<Trade::ImageData3D, &Trade::AbstractImporter::image3D, &Trade::AbstractImporter::image3DCount, &Trade::AbstractImporter::image3DLevelCount>, "Three-dimensional image", py::arg("id"), py::arg("level") = 0);
+        .def("image3d", checkOpenedBoundsResult<Trade::ImageData3D, &Trade::AbstractImporter::image3D, &Trade::AbstractImporter::image3DCount, &Trade::AbstractImporter::image3DLevelCount>, "Three-dimensional image", py::arg("id"), py::arg("level") = 0)
+
+        /* Asynchronous variants */
+        .def("mesh_async", checkOpenedBoundsResultAsync<Trade::MeshData, &Trade::AbstractImporter::mesh, &Trade::AbstractImporter::meshCount, &Trade::AbstractImporter::meshLevelCount>, "Mesh asynchronously", py::arg("id"), py::arg("level") = 0)
+        .def("image1d_async", checkOpenedBoundsResultAsync<Trade::ImageData1D, &Trade::AbstractImporter::image1D, &Trade::AbstractImporter::image1DCount, &Trade::AbstractImporter::image1DLevelCount>, "One-dimensional image asynchronously", py::arg("id"), py::arg("level") = 0)
+        .def("image2d_async", checkOpenedBoundsResultAsync<Trade::ImageData2D, &Trade::AbstractImporter::image2D, &Trade::AbstractImporter::image2DCount, &Trade::AbstractImporter::image2DLevelCount>, "Two-dimensional image asynchronously", py::arg("id"), py::arg("level") = 0)
+        .def("image3d_async", checkOpenedBoundsResultAsync<Trade::ImageData3D, &Trade::AbstractImporter::image3D, &Trade::AbstractImporter::image3DCount, &Trade::AbstractImporter::image3DLevelCount>, "Three-dimensional image asynchronously", py::arg("id"), py::arg("level") = 0);
 
     py::class_<PluginManager::Manager<Trade::AbstractImporter>, PluginManager::AbstractManager> importerManager{m, "ImporterManager", "Plugin manager for importer plugins"};
     corrade::manager(importerManager);
+
+    /* Importer instrumentation */
+    m
+        .def("set_importer_instrumentation", [](bool enabled) {
+            importerInstrumentation().enabled = enabled;
+        }, "Enable or disable importer instrumentation", py::arg("enabled"))
+        .def("importer_stats", []() {
+            py::dict out;
+            for(const auto& plugin: importerInstrumentation().stats) {
+                py::dict functions;
+                for(const auto& function: plugin.second) {
+                    py::dict stats;
+                    stats["calls"] = function.second.calls;
+                    stats["time"] = std::chrono::duration<Double>{function.second.time}.count();
+                    stats["bytes_in"] = function.second.bytesIn;
+                    stats["bytes_out"] = function.second.bytesOut;
+                    functions[py::str(function.first)] = stats;
+                }
+                out[py::str(plugin.first)] = functions;
+            }
+            return out;
+        }, "Importer call statistics")
+        .def("reset_importer_stats", []() {
+            importerInstrumentation().stats.clear();
+        }, "Reset importer call statistics");
 }
 
 }